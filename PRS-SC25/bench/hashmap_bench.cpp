@@ -0,0 +1,94 @@
+// 二元子句哈希表的速度对比：原来的链式HashMap(默认10000007个桶)和utils/hashmap.hpp中的开放寻址HashMap。
+// 用法: hashmap_bench [文字对个数] [变量数]，默认1000000对、1000000个变量。
+// 和preprocess_binary一样以mapv(a, b)为键，每对文字以两种顺序插入；之后查找4n次(一半命中)，
+// 删除四分之一的键，再查找4n次。每个阶段重复rounds次取最快的一次，并检查两者的查找结果相同
+#include "utils/hashmap.hpp"
+#include "legacy_hashmap.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+static double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Workload {
+    std::vector<ll> keys, queries, erased;
+};
+
+// 文字按preprocess中的tolit编码为[2, 2 * vars + 2)，键为a * nlit + b
+static Workload make_workload(int pairs, int vars) {
+    std::mt19937_64 rng(20250101);
+    ll nlit = 2ll * vars + 2;
+    auto lit = [&]() { return (ll)(rng() % (2ull * vars)) + 2; };
+    Workload w;
+    for (int i = 0; i < pairs; i++) {
+        ll a = lit(), b = lit();
+        w.keys.push_back(a * nlit + b);
+        w.keys.push_back(b * nlit + a);
+    }
+    for (size_t i = 0; i < 2 * w.keys.size(); i++)
+        w.queries.push_back(i & 1 ? w.keys[rng() % w.keys.size()] : lit() * nlit + lit());
+    for (size_t i = 0; i < w.keys.size(); i += 4) w.erased.push_back(w.keys[i]);
+    return w;
+}
+
+struct Times {
+    double construct = 1e100, insert = 1e100, get = 1e100, erase = 1e100, reget = 1e100;
+};
+
+template <typename Map, typename Make>
+static Times run(const Workload &w, int rounds, Make make, std::vector<int> &found) {
+    Times best;
+    for (int r = 0; r < rounds; r++) {
+        found.clear();
+        double t = now();
+        Map *map = make();
+        double t1 = now();
+        for (size_t i = 0; i < w.keys.size(); i++) map->insert(w.keys[i], (int)(i >> 1) + 1);
+        double t2 = now();
+        long long sum = 0;
+        for (ll key : w.queries) sum += map->get(key, 0);
+        double t3 = now();
+        for (ll key : w.erased) map->erase(key);
+        double t4 = now();
+        for (ll key : w.queries) sum += map->get(key, 0);
+        double t5 = now();
+        found.push_back((int)sum);
+        delete map;
+        best.construct = std::min(best.construct, t1 - t);
+        best.insert = std::min(best.insert, t2 - t1);
+        best.get = std::min(best.get, t3 - t2);
+        best.erase = std::min(best.erase, t4 - t3);
+        best.reget = std::min(best.reget, t5 - t4);
+    }
+    return best;
+}
+
+static void print(const char *name, const Times &t) {
+    printf("%-8s construct %7.3f  insert %7.3f  get %7.3f  erase %7.3f  get %7.3f  total %7.3f s\n",
+           name, t.construct, t.insert, t.get, t.erase, t.reget,
+           t.construct + t.insert + t.get + t.erase + t.reget);
+}
+
+int main(int argc, char **argv) {
+    int pairs = argc > 1 ? atoi(argv[1]) : 1000000;
+    int vars = argc > 2 ? atoi(argv[2]) : 1000000;
+    const int rounds = 3;
+    if (pairs <= 0 || vars <= 0) {
+        printf("usage: %s [pairs] [vars]\n", argv[0]);
+        return 1;
+    }
+    Workload w = make_workload(pairs, vars);
+    printf("%d pairs, %d vars, %zu keys, %zu lookups per phase\n", pairs, vars, w.keys.size(), w.queries.size());
+
+    std::vector<int> chained_found, open_found;
+    print("chained", run<legacy::HashMap>(w, rounds, [] { return new legacy::HashMap(); }, chained_found));
+    int expected = (int)w.keys.size();
+    print("open", run<HashMap>(w, rounds, [expected] { return new HashMap(expected); }, open_found));
+    printf("%s\n", chained_found == open_found ? "same results" : "DIFFERENT results");
+    return chained_found == open_found ? 0 : 1;
+}
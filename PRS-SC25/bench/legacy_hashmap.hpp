@@ -0,0 +1,65 @@
+#pragma once
+
+// 改为开放寻址之前的链式哈希表，只供hashmap_bench对照速度
+#include <cstddef>
+
+namespace legacy {
+
+typedef long long ll;
+
+struct HashNode {
+    ll key;
+    int val;
+    HashNode *next;
+};
+
+struct HashMap {
+    int size;
+    HashNode **table;
+
+    HashMap(int sz = 10000007) : size(sz), table(new HashNode*[sz]) {
+        for (int i = 0; i < sz; i++) table[i] = NULL;
+    }
+
+    ~HashMap() {
+        for (int i = 0; i < size; i++) {
+            HashNode *pointer = table[i];
+            while (pointer != NULL) {
+                HashNode *prev = pointer;
+                pointer = pointer->next;
+                delete prev;
+            }
+        }
+        delete []table;
+    }
+
+    int get(ll key, int vsign) {
+        for (HashNode *pointer = table[key % size]; pointer != NULL; pointer = pointer->next)
+            if (pointer->key == key) return pointer->val;
+        return vsign;
+    }
+
+    void erase(ll key) {
+        HashNode **link = &table[key % size];
+        for (HashNode *pointer = *link; pointer != NULL; link = &pointer->next, pointer = *link) {
+            if (pointer->key == key) {
+                *link = pointer->next;
+                delete pointer;
+                return;
+            }
+        }
+    }
+
+    void insert(ll key, int value) {
+        HashNode **link = &table[key % size];
+        for (HashNode *pointer = *link; pointer != NULL; link = &pointer->next, pointer = *link) {
+            if (pointer->key == key) {
+                pointer->val = value;
+                return;
+            }
+        }
+        *link = new HashNode{key, value, NULL};
+    }
+};
+
+}
@@ -0,0 +1,69 @@
+// DIMACS解析速度对比：原来的串行readfile和utils/parse.hpp中的并行readfile。
+// 用法: parse_bench <cnf> [线程数...]，不给线程数时测试1和hardware_concurrency。
+// 每种解析重复rounds次取最快的一次，并检查两者得到的子句完全相同
+#include "utils/parse.hpp"
+#include "legacy_parse.hpp"
+#include <sys/stat.h>
+
+static double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool same(vec<vec<int>> &a, int na, vec<vec<int>> &b, int nb) {
+    if (na != nb) return false;
+    for (int i = 1; i <= na; i++) {
+        if (a[i].size() != b[i].size()) return false;
+        for (int j = 0; j < a[i].size(); j++)
+            if (a[i][j] != b[i][j]) return false;
+    }
+    return true;
+}
+
+static void release(vec<vec<int>> &clause) {
+    for (int i = 0; i < clause.size(); i++) clause[i].clear(true);
+    clause.clear(true);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        printf("usage: %s <cnf> [threads...]\n", argv[0]);
+        return 1;
+    }
+    const char *file = argv[1];
+    const int rounds = 3;
+    struct stat st;
+    if (stat(file, &st)) {
+        printf("cannot open %s\n", file);
+        return 1;
+    }
+    double mb = st.st_size / 1048576.0;
+    std::vector<int> threads;
+    for (int i = 2; i < argc; i++) threads.push_back(atoi(argv[i]));
+    if (threads.empty()) threads = {1, (int)std::thread::hardware_concurrency()};
+
+    int vars, clauses, ref_clauses = 0;
+    vec<vec<int>> reference;
+    double best = 1e100;
+    for (int r = 0; r < rounds; r++) {
+        release(reference);
+        double t = now();
+        legacy::readfile(file, &vars, &ref_clauses, reference);
+        best = std::min(best, now() - t);
+    }
+    printf("legacy      %8.3f s %8.1f MB/s  %d clauses\n", best, mb / best, ref_clauses);
+
+    for (int n : threads) {
+        vec<vec<int>> clause;
+        best = 1e100;
+        for (int r = 0; r < rounds; r++) {
+            release(clause);
+            double t = now();
+            readfile(file, &vars, &clauses, clause, n);
+            best = std::min(best, now() - t);
+        }
+        printf("parallel %2d %8.3f s %8.1f MB/s  %s\n", n, best, mb / best,
+               same(reference, ref_clauses, clause, clauses) ? "same clauses" : "DIFFERENT clauses");
+        release(clause);
+    }
+    return 0;
+}
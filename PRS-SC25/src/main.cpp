@@ -30,6 +30,8 @@ int main(int argc, char *argv[]) {
         res = prs->mix_solve(OPT(filename).c_str());
     }
 
+    // 流水线模式下预处理线程可能仍在输出，锁住stdout保证结果和模型连续输出
+    flockfile(stdout);
     if(res == 10) {
         printf("s SATISFIABLE\n");
         vec<int> &model = prs->getModel();
@@ -43,6 +45,7 @@ int main(int argc, char *argv[]) {
     } else {
         printf("s UNKNOWN\n");
     }
+    funlockfile(stdout);
 
     return 0;
 }
\ No newline at end of file
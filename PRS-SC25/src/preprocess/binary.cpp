@@ -9,10 +9,121 @@ int preprocess::find(int x) {
     return f[x];
 }
 
+// 合并文字x和y(内部编码)的等价类，x与y同真同假，已在同一类但符号矛盾时返回false
+bool preprocess::merge_literals(int x, int y) {
+    int u = toiidx(x), v = toiidx(y);
+    int fa = find(u), fb = find(v);
+    int sig = sign(x) * sign(y);
+    //sig == 1 : a = b   -1 : a = -b
+    if (fa < fb) {
+        f[fa] = fb;
+        val[fa] = sig / (val[u] * val[v]);
+        if (varval[fa])
+            varval[fb] = val[fa] * varval[fa];
+    }
+    else if (fa > fb) {
+        f[fb] = fa;
+        val[fb] = sig / (val[u] * val[v]);
+        if (varval[fb])
+            varval[fa] = val[fb] * varval[fb];
+    }
+    else if (sig != val[u] * val[v])
+        return false;
+    return true;
+}
+
+// 二元子句的蕴含图：子句a∨b对应边¬a→b和¬b→a，按起点存成CSR。
+// 用非递归的Tarjan算法求强连通分量，分量中的文字两两等价，全部并入分量根所在的等价类，
+// 分量中同时含有x和¬x时公式不可满足。之后从没有入边的文字l出发广度优先搜索，
+// 能到达¬l或同时到达某个y和¬y时l是失败文字，固定¬l。
+// 得到的等价关系和赋值由之后的改写统一代入，返回false表示不可满足
+bool preprocess::binary_scc(int &equivalences, int &units) {
+    int n = vars << 1;
+    vec<int> start(n + 1, 0), adj, pos(n, 0);
+    for (int i = 1; i <= clauses; i++) {
+        if (clause_delete[i] || clause[i].size() != 2) continue;
+        ++start[negative(clause[i][0]) + 1];
+        ++start[negative(clause[i][1]) + 1];
+    }
+    for (int i = 0; i < n; i++) start[i + 1] += start[i];
+    ticks += clauses + n;
+    if (!start[n]) return true;
+    adj.growTo(start[n], 0);
+    for (int i = 0; i < n; i++) pos[i] = start[i];
+    for (int i = 1; i <= clauses; i++) {
+        if (clause_delete[i] || clause[i].size() != 2) continue;
+        int x = clause[i][0], y = clause[i][1];
+        adj[pos[negative(x)]++] = y;
+        adj[pos[negative(y)]++] = x;
+    }
+
+    // index为访问次序，low为能回到的最小次序，comp为所在分量的编号(-1为尚未确定)
+    vec<int> index(n, -1), low(n, 0), comp(n, -1), stk, call;
+    int counter = 0, comps = 0;
+    for (int s = 0; s < n; s++) {
+        if (index[s] != -1 || start[s] == start[s + 1]) continue;
+        index[s] = low[s] = counter++, pos[s] = start[s];
+        stk.push(s), call.push(s);
+        while (call.size()) {
+            int v = call.last();
+            if (pos[v] < start[v + 1]) {
+                int w = adj[pos[v]++];
+                if (index[w] == -1) {
+                    index[w] = low[w] = counter++, pos[w] = start[w];
+                    stk.push(w), call.push(w);
+                }
+                else if (comp[w] == -1 && index[w] < low[v]) low[v] = index[w];
+                continue;
+            }
+            call.pop();
+            if (call.size() && low[v] < low[call.last()]) low[call.last()] = low[v];
+            if (low[v] != index[v]) continue;
+            int top = stk.size();
+            do comp[stk[--top]] = comps; while (stk[top] != v);
+            for (int j = top; j < stk.size(); j++) {
+                int w = stk[j];
+                if (comp[negative(w)] == comps) return false;
+                if (w == v) continue;
+                if (!merge_literals(w, v)) return false;
+                ++equivalences;
+            }
+            stk.setsize(top);
+            ++comps;
+        }
+    }
+    ticks += 2ll * start[n];
+
+    // 失败文字只需从根出发：非根文字失败时，能到达它的根也失败
+    vec<int> indeg(n, 0), stamp(n, -1), bfs;
+    for (int i = 0; i < start[n]; i++) ++indeg[adj[i]];
+    for (int l = 0; l < n; l++) {
+        if (indeg[l] || start[l] == start[l + 1] || varval[toiidx(l)]) continue;
+        if (out_of_budget()) break;
+        bfs.clear();
+        bfs.push(l), stamp[l] = l;
+        bool failed = false;
+        for (int h = 0; h < bfs.size() && !failed; h++) {
+            int x = bfs[h];
+            ticks += start[x + 1] - start[x];
+            for (int j = start[x]; j < start[x + 1]; j++) {
+                int y = adj[j];
+                if (stamp[y] == l) continue;
+                if (y == negative(l) || stamp[negative(y)] == l) { failed = true; break; }
+                stamp[y] = l, bfs.push(y);
+            }
+        }
+        if (!failed) continue;
+        varval[toiidx(l)] = -sign(l);
+        ++units;
+    }
+    return true;
+}
+
 bool preprocess::preprocess_binary() {
-    HashMap *C = new HashMap();
+    int binaries = 0;
     for (int i = 1; i <= clauses; i++) {
         int l = clause[i].size();
+        binaries += l == 2;
         for (int j = 0; j < l; j++) {
             clause[i][j] = tolit(clause[i][j]);
         }
@@ -20,75 +131,57 @@ bool preprocess::preprocess_binary() {
     nlit = (vars << 1) + 2;
     for (int i = 1; i <= vars; i++) f[i] = i, val[i] = 1, varval[i] = color[i] = resseen[tolit(i)] = resseen[tolit(-i)] = 0;
     for (int i = 1; i <= clauses; i++) clause_delete[i] = 0;
+    // 每个二元子句以两种顺序插入，轮次中新产生的二元子句插入时再扩容
+    HashMap C(binaries * 2);
     int len = 0;
+    ticks += clauses;
     for (int i = 1; i <= clauses; i++) {
         if (clause[i].size() != 2) continue;
         nxtc[++len] = i;
         ll id1 = mapv(clause[i][0], clause[i][1]),
            id2 = mapv(clause[i][1], clause[i][0]);
-        C->insert(id1, i);
-        C->insert(id2, i);
+        C.insert(id1, i);
+        C.insert(id2, i);
     }
-    int simplify = 1, turn = 0;
-    while (simplify) {
-        simplify = 0;
+    // 蕴含图只在开始时处理一次，等价关系由第一轮改写一次代入；
+    // 之后的轮次只代入新得到的单元，没有新单元时结束
+    int equivalences = 0, units = 0;
+    if (!binary_scc(equivalences, units)) return false;
+    int pending = 1, turn = 0;
+    while (true) {
+        // 每一轮结束时子句都已按当前的等价关系和赋值改写，可以在这里停止
+        if (turn && out_of_budget()) break;
         ++turn;
-        int s1 = 0, s2 = 0, s3 = 0;
+        // 成对的二元子句a∨b和a∨¬b给出单元a，第一轮检查全部二元子句，之后只检查上一轮改写后新出现的
+        ticks += len;
         for (int k = 1; k <= len; k++) {
             int i = nxtc[k];
             if (clause[i].size() != 2 || clause_delete[i]) continue;
-            ll id1 = mapv(negative(clause[i][0]), negative(clause[i][1])),
-               id2 = mapv(clause[i][0], negative(clause[i][1])),
+            ll id2 = mapv(clause[i][0], negative(clause[i][1])),
                id3 = mapv(negative(clause[i][0]), clause[i][1]);
-            int r = C->get(id1, 0);
-            if (r) {
-                simplify = 1;
-                ++s1;
-                clause_delete[r] = clause_delete[i] = 1;
-                int u = toiidx(clause[i][0]), v = toiidx(clause[i][1]);
-                int fa = find(u), fb = find(v);
-                int sig = sign(clause[i][0]) * sign(clause[i][1]) * (-1);
-                //sig == 1 : a = b   -1 : a = -b
-                if (fa != fb) {
-                    if (fa < fb) {
-                        f[fa] = fb;
-                        val[fa] = sig / (val[u] * val[v]);
-                        if (varval[fa])
-                            varval[fb] = val[fa] * varval[fa];
-                    }
-                    else if (fa > fb) {
-                        f[fb] = fa;
-                        val[fb] = sig / (val[u] * val[v]);
-                        if (varval[fb])
-                            varval[fa] = val[fb] * varval[fb];
-                    }
-                }
-                else {
-                    if (sig != val[u] * val[v])
-                        return false;
-                }
-            }
-            int d1 = C->get(id2, 0);
+            int d1 = C.get(id2, 0);
             if (d1) {
                 int v = toiidx(clause[i][0]);
                 if (varval[v] && varval[v] != sign(clause[i][0])) {
                     return false;
                 }
                 clause_delete[d1] = clause_delete[i] = 1;
-                simplify = 1;
+                if (!varval[v]) pending = 1;
                 varval[v] = sign(clause[i][0]);
             }
-            int d2 = C->get(id3, 0);
+            int d2 = C.get(id3, 0);
             if (d2) {
                 int v = toiidx(clause[i][1]);
                 if (varval[v] && varval[v] != sign(clause[i][1])) {
                     return false;
                 }
                 clause_delete[d2] = clause_delete[i] = 1;
-                simplify = 1;
+                if (!varval[v]) pending = 1;
                 varval[v] = sign(clause[i][1]); 
             }
         }
+        if (!pending) break;
+        pending = 0;
 
         for (int i = 1; i <= vars; i++) {
             int x = find(i);
@@ -109,10 +202,12 @@ bool preprocess::preprocess_binary() {
                 else varval[i] = varval[f[i]] * val[i];
             }
         len = 0;
+        ticks += vars + vars;
 
         for (int i = 1; i <= clauses; i++) {
             if (clause_delete[i]) continue;
             int l = clause[i].size(), oril = l;
+            ticks += l;
             for (int j = 0; j < l; j++) {
                 int v = toiidx(clause[i][j]), fa = f[v];
                 a[j] = tolit(sign(clause[i][j]) * val[v] * fa);
@@ -122,39 +217,34 @@ bool preprocess::preprocess_binary() {
                 int x = varval[toiidx(a[j])];
                 if (x) {
                     int k = x * sign(a[j]);
-                    if (k == 1) {
-                        if (!clause_delete[i]) simplify = 1;
-                        clause_delete[i] = 1, a[t++] = a[j];
-                    }
+                    if (k == 1) clause_delete[i] = 1, a[t++] = a[j];
                 }
                 else a[t++] = a[j];
             }
             if (t == 0) return false;
-            if (t != l) simplify = 1, l = t;
+            l = t;
             
             t = 0;
             for (int j = 0; j < l; j++) {
                 if (resseen[a[j]] == i) continue;
                 resseen[a[j]] = i, a[t++] = a[j];
             }
-            if (t != l) simplify = 1, l = t;
+            l = t;
             for (int j = 0; j < l; j++)
-                if (resseen[negative(a[j])] == i && !clause_delete[i]) {
-                    clause_delete[i] = 1, simplify = 1;
-                }
+                if (resseen[negative(a[j])] == i) clause_delete[i] = 1;
             for (int j = 0; j < l; j++) resseen[a[j]] = 0;
                 
             if (l == 1) {
                 if (sign(a[0]) * varval[toiidx(a[0])] == -1) return false;
+                if (!varval[toiidx(a[0])]) pending = 1;
                 varval[toiidx(a[0])] = sign(a[0]);
-                simplify = 1;
             }
             if (!clause_delete[i] && l == 2 && oril != 2) {
                 nxtc[++len] = i;
                 ll id1 = mapv(a[0], a[1]),
                    id2 = mapv(a[1], a[0]);
-                C->insert(id1, i);
-                C->insert(id2, i);
+                C.insert(id1, i);
+                C.insert(id2, i);
             }
             else if (!clause_delete[i] && l == 2 &&  oril == 2) {
                 if (a[0] == clause[i][0] && a[1] == clause[i][1]) ;
@@ -163,8 +253,8 @@ bool preprocess::preprocess_binary() {
                     nxtc[++len] = i;
                     ll id1 = mapv(a[0], a[1]),
                        id2 = mapv(a[1], a[0]);
-                    C->insert(id1, i);
-                    C->insert(id2, i);
+                    C.insert(id1, i);
+                    C.insert(id2, i);
                 }
             }
             clause[i].clear();
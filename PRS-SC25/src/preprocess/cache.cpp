@@ -0,0 +1,247 @@
+#include "cache.hpp"
+#include "utils/parse.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static_assert(sizeof(size_t) == sizeof(uint64_t), "cache stores offsets as 64-bit words");
+
+namespace {
+
+const char MAGIC[8] = {'P', 'R', 'S', 'C', 'A', 'C', 'H', 'E'};
+const uint32_t VERSION = 1;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    int32_t result;
+    uint64_t hash, size;
+    int32_t vars, clauses, orivars, oriclauses;
+    int32_t res_clauses, resolutions, model_vars, unused;
+    uint64_t literals, res_literals;
+};
+
+size_t align8(size_t bytes) { return (bytes + 7) & ~(size_t)7; }
+
+// 各数组在文件中的偏移，写入和读取都从头部的计数推出同一布局
+struct Layout {
+    size_t offsets, lits, mapto, mapval, res_offsets, res_lits, resolution, model, total;
+
+    explicit Layout(const Header& h) {
+        size_t pos = align8(sizeof(Header));
+        auto take = [&pos](size_t bytes) { size_t at = pos; pos = align8(pos + bytes); return at; };
+        bool formula = h.result == 0;
+        offsets     = take(formula ? (h.clauses + 1) * sizeof(uint64_t) : 0);
+        lits        = take(formula ? h.literals * sizeof(int32_t) : 0);
+        mapto       = take(formula ? (h.orivars + 1) * sizeof(int32_t) : 0);
+        mapval      = take(formula ? (h.orivars + 1) * sizeof(int32_t) : 0);
+        res_offsets = take(h.res_clauses ? (h.res_clauses + 1) * sizeof(uint64_t) : 0);
+        res_lits    = take(h.res_literals * sizeof(int32_t));
+        resolution  = take(h.resolutions ? (h.resolutions + 1) * sizeof(int32_t) : 0);
+        model       = take(h.model_vars ? (h.model_vars + 1) * sizeof(int32_t) : 0);
+        total = pos;
+    }
+};
+
+// 每次处理8个字节的乘法哈希，足以区分回归测试中的不同实例
+uint64_t hash_bytes(const char* p, size_t n) {
+    const uint64_t k = 0x9e3779b97f4a7c15ull;
+    uint64_t h = n * k, w;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        memcpy(&w, p + i, 8);
+        h = (h ^ w) * k;
+        h ^= h >> 29;
+    }
+    w = 0;
+    memcpy(&w, p + i, n - i);
+    h = (h ^ w) * k;
+    h ^= h >> 32;
+    h *= 0xff51afd7ed558ccdull;
+    return h ^ (h >> 33);
+}
+
+class Writer {
+public:
+    explicit Writer(FILE* file) : file(file) {}
+
+    void write(const void* data, size_t bytes) {
+        if (bytes && fwrite(data, 1, bytes, file) != bytes) ok = false;
+        pos += bytes;
+    }
+
+    // 补齐到布局中下一个数组的起点
+    void seek(size_t at) {
+        static const char zeros[8] = {0};
+        if (at < pos || at - pos > 8) ok = false;
+        else write(zeros, at - pos);
+    }
+
+    bool ok = true;
+
+private:
+    FILE* file;
+    size_t pos = 0;
+};
+
+} // namespace
+
+PreprocessCache::PreprocessCache(const std::string& dir, const char* filename, const preprocess_effort& effort) {
+    if (dir.empty()) return;
+    InputBuffer input;
+    if (!input.open(filename)) return;
+    size = input.end - input.begin;
+    const ll settings[] = {effort.circuit, effort.gauss, effort.card, effort.resolution, effort.binary, effort.min_ticks,
+                            effort.elim_occs, effort.elim_length, effort.card_size};
+    hash = hash_bytes(input.begin, size) ^ hash_bytes((const char*)settings, sizeof settings);
+    char name[64];
+    snprintf(name, sizeof name, "/%016llx-%llu.prs", (unsigned long long)hash, (unsigned long long)size);
+    path = dir + name;
+}
+
+bool PreprocessCache::load(preprocess* pre, Formula& formula, int& result) {
+    if (!enabled()) return false;
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) || (size_t)st.st_size < sizeof(Header)) {
+        close(fd);
+        return false;
+    }
+    size_t bytes = st.st_size;
+    void* p = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return false;
+    std::shared_ptr<const void> mapping(p, [bytes](const void* q) { munmap((void*)q, bytes); });
+
+    const char* base = (const char*)p;
+    const Header& h = *(const Header*)base;
+    if (memcmp(h.magic, MAGIC, sizeof MAGIC) || h.version != VERSION ||
+        h.hash != hash || h.size != size || Layout(h).total != bytes)
+        return false;
+    Layout layout(h);
+
+    result = h.result;
+    pre->vars = h.vars, pre->clauses = h.clauses;
+    pre->orivars = h.orivars, pre->oriclauses = h.oriclauses;
+
+    if (h.model_vars) {
+        const int* model = (const int*)(base + layout.model);
+        pre->model = new int[h.model_vars + 1];
+        memcpy(pre->model, model, (h.model_vars + 1) * sizeof(int));
+    }
+    if (result) return true;
+
+    // mapto/mapval和恢复数据在求解结束后会被修改，拷贝出来；公式直接引用映射
+    const int* mapto = (const int*)(base + layout.mapto);
+    const int* mapval = (const int*)(base + layout.mapval);
+    pre->mapto = new int[h.orivars + 10];
+    pre->mapval = new int[h.orivars + 10];
+    memcpy(pre->mapto, mapto, (h.orivars + 1) * sizeof(int));
+    memcpy(pre->mapval, mapval, (h.orivars + 1) * sizeof(int));
+
+    pre->res_clauses = h.res_clauses;
+    if (h.res_clauses) {
+        const size_t* offsets = (const size_t*)(base + layout.res_offsets);
+        const int* lits = (const int*)(base + layout.res_lits);
+        pre->res_clause.clear();
+        pre->res_clause.push();
+        for (int i = 1; i <= h.res_clauses; i++) {
+            pre->res_clause.push();
+            for (size_t j = offsets[i - 1]; j < offsets[i]; j++)
+                pre->res_clause[i].push(lits[j]);
+        }
+    }
+    pre->resolutions = h.resolutions;
+    if (h.resolutions) {
+        const int* resolution = (const int*)(base + layout.resolution);
+        pre->resolution.clear();
+        for (int i = 0; i <= h.resolutions; i++) pre->resolution.push(resolution[i]);
+    }
+
+    formula.attach(h.vars, h.clauses,
+                   (const size_t*)(base + layout.offsets),
+                   (const int*)(base + layout.lits), std::move(mapping));
+    return true;
+}
+
+bool PreprocessCache::store(const preprocess* pre, const Formula& formula, int result) {
+    if (!enabled()) return false;
+
+    Header h;
+    memset(&h, 0, sizeof h);
+    memcpy(h.magic, MAGIC, sizeof MAGIC);
+    h.version = VERSION;
+    h.result = result;
+    h.hash = hash, h.size = size;
+    h.orivars = pre->orivars, h.oriclauses = pre->oriclauses;
+    if (result == 10) {
+        h.vars = pre->vars;
+        h.model_vars = pre->vars;
+    } else if (result == 0) {
+        h.vars = formula.vars;
+        h.clauses = formula.size();
+        h.literals = formula.literals();
+        // 没有消去变量时res_clauses/resolutions未初始化，以数组是否为空为准
+        h.res_clauses = pre->res_clause.size() ? pre->res_clauses : 0;
+        h.resolutions = pre->resolution.size() ? pre->resolutions : 0;
+        for (int i = 1; i <= h.res_clauses; i++) h.res_literals += pre->res_clause[i].size();
+    }
+    Layout layout(h);
+
+    std::string tmp = path + ".tmp." + std::to_string(getpid());
+    FILE* file = fopen(tmp.c_str(), "wb");
+    if (!file) {
+        printf("c can not write cache file %s\n", tmp.c_str());
+        return false;
+    }
+
+    Writer out(file);
+    out.write(&h, sizeof h);
+    if (result == 0) {
+        out.seek(layout.offsets);
+        out.write(formula.offset_data(), (h.clauses + 1) * sizeof(size_t));
+        out.seek(layout.lits);
+        out.write(formula.literal_data(), h.literals * sizeof(int));
+        out.seek(layout.mapto);
+        out.write(pre->mapto, (h.orivars + 1) * sizeof(int));
+        out.seek(layout.mapval);
+        out.write(pre->mapval, (h.orivars + 1) * sizeof(int));
+    }
+    if (h.res_clauses) {
+        out.seek(layout.res_offsets);
+        size_t offset = 0;
+        out.write(&offset, sizeof offset);
+        for (int i = 1; i <= h.res_clauses; i++) {
+            offset += pre->res_clause[i].size();
+            out.write(&offset, sizeof offset);
+        }
+        out.seek(layout.res_lits);
+        for (int i = 1; i <= h.res_clauses; i++)
+            out.write(pre->res_clause[i].data, pre->res_clause[i].size() * sizeof(int));
+    }
+    if (h.resolutions) {
+        out.seek(layout.resolution);
+        out.write(pre->resolution.data, (h.resolutions + 1) * sizeof(int));
+    }
+    if (h.model_vars) {
+        out.seek(layout.model);
+        out.write(pre->model, (h.model_vars + 1) * sizeof(int));
+    }
+    out.seek(layout.total);
+
+    bool ok = out.ok;
+    if (fclose(file)) ok = false;
+    if (ok && rename(tmp.c_str(), path.c_str())) ok = false;
+    if (!ok) {
+        unlink(tmp.c_str());
+        printf("c can not write cache file %s\n", path.c_str());
+    }
+    return ok;
+}
@@ -0,0 +1,32 @@
+#ifndef _cache_hpp_INCLUDED
+#define _cache_hpp_INCLUDED
+
+#include <cstdint>
+#include <string>
+
+#include "preprocess.hpp"
+#include "utils/formula.hpp"
+
+// 预处理结果缓存：以输入文件内容的哈希为键，把预处理的结果(化简后的公式、
+// mapto/mapval以及恢复模型用的res_clause/resolution)写成一个二进制文件。
+// 文件中所有数组按8字节对齐，之后的运行直接mmap，化简后的公式不拷贝
+class PreprocessCache {
+public:
+    // dir为空时不启用缓存；各化简过程的工作量设置也计入键中，时间上限不计入，被时间上限截断的结果不写入缓存
+    PreprocessCache(const std::string& dir, const char* filename, const preprocess_effort& effort);
+
+    bool enabled() const { return !path.empty(); }
+    const std::string& file() const { return path; }
+
+    // 命中时恢复预处理器状态和公式，result为预处理的返回值(0/10/20)
+    bool load(preprocess* pre, Formula& formula, int& result);
+
+    // 预处理结束后写入，先写临时文件再改名，多个进程同时写也不会读到半个文件
+    bool store(const preprocess* pre, const Formula& formula, int result);
+
+private:
+    std::string path;
+    uint64_t hash = 0, size = 0;
+};
+
+#endif
@@ -3,9 +3,12 @@
 #include <cmath>
 
 int preprocess::search_almost_one() {
-    HashMap *C = new HashMap();
+    int binaries = 0;
+    for (int i = 1; i <= clauses; i++) binaries += clause[i].size() == 2;
+    HashMap C(binaries * 2);
     nlit = 2 * vars + 2;
     occur = new vec<int>[nlit]; 
+    ticks += clauses;
     for (int i = 1; i <= clauses; i++) {
         clause_delete[i] = 0;
         if (clause[i].size() != 2) continue;
@@ -13,8 +16,8 @@ int preprocess::search_almost_one() {
         int y = tolit(clause[i][1]);
         ll id1 = mapv(x, y);
         ll id2 = mapv(y, x);
-        C->insert(id1, i);
-        C->insert(id2, i);
+        C.insert(id1, i);
+        C.insert(id2, i);
         occur[x].push(y);
         occur[y].push(x);
     }
@@ -24,6 +27,8 @@ int preprocess::search_almost_one() {
     vec<int> ino, nei;
     for (int i = 0; i < vars * 2; i++) {
         if (seen[i] || !occur[i].size()) continue;
+        ticks += occur[i].size();
+        if (out_of_budget()) break;
         seen[i] = 1;
         nei.clear();
         for (int j = 0; j < occur[i].size(); j++)
@@ -36,7 +41,7 @@ int preprocess::search_almost_one() {
                 int v = nei[j], flag = 1;
                 for (int k = 0; k < ino.size(); k++) {
                     ll id = mapv(v, ino[k]);
-                    int d1 = C->get(id, 0);
+                    int d1 = C.get(id, 0);
                     if (!d1) {flag = 0; break;}
                     q[k] = d1;
                 }
@@ -44,12 +49,13 @@ int preprocess::search_almost_one() {
                     for (int k = 0; k < ino.size(); k++) {
                         clause_delete[q[k]] = 1;
                         ll id1 = mapv(v, ino[k]), id2 = mapv(ino[k], v);
-                        C->erase(id1);
-                        C->erase(id2);
+                        C.erase(id1);
+                        C.erase(id2);
                     }
                     ino.push(v);
                 }
             }
+            ticks += 1ll * nei.size() * ino.size();
             if (ino.size() >= 2) {
                 card_one.push();
                 for (int j = 0; j < ino.size(); j++) {
@@ -64,19 +70,23 @@ int preprocess::search_almost_one() {
     return card_one.size();
 }
 
-void preprocess::upd_occur(int v, int s) {
+// 从文字v的出现表中删去s，返回扫描的出现表长度
+int preprocess::upd_occur(int v, int s) {
     int x = abs(v);
-    int t = 0;
+    int t = 0, len;
     if (v > 0) {
+        len = occurp[x].size();
         for (int j = 0; j < occurp[x].size(); j++)
             if (occurp[x][j] != s) occurp[x][t++] = occurp[x][j]; 
         occurp[x].setsize(t);
     }
     else {
+        len = occurn[x].size();
         for (int j = 0; j < occurn[x].size(); j++)
             if (occurn[x][j] != s) occurn[x][t++] = occurn[x][j];
         occurn[x].setsize(t);
     }
+    return len;
 }
 
 int preprocess::scc_almost_one() {
@@ -97,7 +107,9 @@ int preprocess::scc_almost_one() {
         flag = 0;
         for (int i = 1; i <= vars; i++) {
             if (!occurp[i].size() || !occurn[i].size()) continue;
-            if (card_one.size() + occurp[i].size() * occurp[i].size() > 1e7 / vars) return 0;
+            if ((card_one.size() + 1ll * occurp[i].size() * occurn[i].size()) * (vars + 1) > effort.card_size) return 0;
+            ticks += 1ll * occurp[i].size() * occurn[i].size() * vars;
+            if (out_of_budget()) return 0;
             flag = 1;
             for (int ip = 0; ip < occurp[i].size(); ip++) 
                 cdel[occurp[i][ip]] = 1;
@@ -107,6 +119,9 @@ int preprocess::scc_almost_one() {
                 int op = occurp[i][ip];
                 for (int in = 0; in < occurn[i].size(); in++) {
                     int on = occurn[i][in];
+                    // 中途停止时card_one不完整，返回0后由调用者整体丢弃
+                    ticks += card_one[op].size() + card_one[on].size();
+                    if (out_of_budget()) return 0;
                     card_one.push();
                     cdel.push(0);
                     int id = card_one.size() - 1;
@@ -131,13 +146,15 @@ int preprocess::scc_almost_one() {
             for (int ip = 0; ip < occurp[i].size(); ip++) {
                 int op = occurp[i][ip];
                 for (int j = 0; j < card_one[op].size(); j++)
-                    upd_occur(card_one[op][j], op);
+                    ticks += upd_occur(card_one[op][j], op);
+                if (out_of_budget()) return 0;
             }
             
             for (int in = 0; in < occurn[i].size(); in++) {
                 int on = occurn[i][in];
                 for (int j = 0; j < card_one[on].size(); j++)
-                    upd_occur(card_one[on][j], on);
+                    ticks += upd_occur(card_one[on][j], on);
+                if (out_of_budget()) return 0;
             }
         }       
     } while(flag);
@@ -203,6 +220,20 @@ int preprocess::check_card(int id) { //0: wrong  -1:useless    1:normal
 
 int preprocess::card_elimination() {
     //sigma aixi <= b
+    // 每行是长为vars+1的稠密数组，分配之前先按矩阵大小计入预算
+    ll rows = 0;
+    for (int i = 0; i < card_one.size(); i++)
+        if (!cdel[i]) ++rows;
+    for (int i = 1; i <= clauses; i++)
+        if (!clause_delete[i]) ++rows;
+    ticks += rows * (vars + 1);
+    if (out_of_budget()) {
+        for (int i = 0; i < card_one.size(); i++)
+            card_one[i].clear(true);
+        card_one.clear(true);
+        cdel.clear(true);
+        return 1;
+    }
     vec<int> row_size;
     for (int i = 0; i < card_one.size(); i++) {
         if (cdel[i]) continue;
@@ -259,6 +290,8 @@ int preprocess::card_elimination() {
     vec<int> elim;
     elim.growTo(vars + 1, 0);
     for (int turn = 1; turn <= vars; turn++) {
+        ticks += 1ll * row * (vars + 1);
+        if (out_of_budget()) return 1;
         int v = 0;
         for (int i = 1; i <= vars; i++) {
             if (elim[i]) continue;
@@ -283,7 +316,9 @@ int preprocess::card_elimination() {
                 low.push(i);
             }
         }
-        if (mat.size() + upp.size() * low.size() > 1e7/vars || mat.size() > 1e3) return 1;
+        if ((mat.size() + 1ll * upp.size() * low.size()) * (vars + 1) > effort.card_size) return 1;
+        ticks += 1ll * upp.size() * low.size() * (vars + 1);
+        if (out_of_budget()) return 1;
         for (int iu = 0; iu < upp.size(); iu++) {
             int u = upp[iu];
             for (int il = 0; il < low.size(); il++) {
@@ -306,19 +341,21 @@ int preprocess::card_elimination() {
     return 1;
 }
 
+// 返回0表示无解，-1表示公式中没有可用的基数约束或矩阵超过card_size，没有运行消去
 int preprocess::preprocess_card() {
     int sone = search_almost_one();
-    if (!sone) return 1;
+    if (!sone) return -1;
     int scc = scc_almost_one();
     int sz = card_one.size();
     for (int i = 1; i <= clauses; i++)
         if (!clause_delete[i]) ++sz;
-    if (sz > 1e7 / vars || !scc || sz > 1e3) {
+    // scc_almost_one在预算用尽时也返回0，这时按正常运行结束，由run_pass报告预算用尽
+    if (!scc || 1ll * sz * (vars + 1) > effort.card_size) {
         for (int i = 0; i < card_one.size(); i++)
             card_one[i].clear(true);
         card_one.clear(true);
         cdel.clear(true);
-        return 1;
+        return !scc && aborted ? 1 : -1;
     }
     int res = card_elimination();
     for (int i = 0; i < mat.size(); i++)
@@ -241,17 +241,22 @@ bool preprocess::_simulate(Bitset** result, int bit_size) {
     return res;
 }
 
-bool preprocess::do_epcec() {
+// 返回0表示找到反例(SAT)，1表示穷举完毕(UNSAT)，-1表示预算用尽
+int preprocess::do_epcec() {
     Bitset** result = new Bitset*[maxvar + 1];
     for (int i = 1; i <= vars; i++) result[i] = nullptr;
     int nri = epcec_rin.size(), ni = epcec_in.size();
     const int maxR = 20;
     int bit_size = 1 << std::min(maxR, nri);
+    // 每次模拟对每个门计算bit_size/64个字
+    ll simulate_ticks = 1ll * gate.size() * std::max(1, bit_size / 64);
     if(nri > maxR) {
         int extra_len = nri - maxR;
         ull extra_values = 0;
 
         while(extra_values < (1LL << (extra_len)) ) {
+            ticks += simulate_ticks;
+            if (out_of_budget()) return -1;
             for(int i=0; i<ni; i++) {
                 int v = epcec_in[i]; 
                 result[v] = new Bitset;
@@ -299,6 +304,8 @@ bool preprocess::do_epcec() {
             if (!res) return 0;
         }
     } else {
+        ticks += simulate_ticks;
+        if (out_of_budget()) return -1;
         for(int i=0; i<ni; i++) {
             int v = epcec_in[i]; 
             result[v] = new Bitset;
@@ -339,11 +346,19 @@ bool preprocess::do_epcec() {
 }
 
 int preprocess::preprocess_circuit() {
+    // 模拟时每个门都要保存一个bitset，公式太大时内存不够，与预算无关
+    if (vars > 1e5 || clauses > 1e6) return -1;
+    ticks += clauses;
     int res = cnf2aig();
     if (!res || rins <= 16 || rins > 32) goto failed;
 
     epcec_preprocess();
     res = do_epcec();
+    if (res < 0) {
+        delete []topo_counter;
+        delete []used;
+        goto failed;
+    }
     if (!res) {
         int *copy_model = new int[vars + 1];
 		for (int i = 1; i <= vars; i++) {
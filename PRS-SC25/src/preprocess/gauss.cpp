@@ -29,6 +29,7 @@ int preprocess::search_xors() {
     for (int i = 1; i <= clauses; i++) {
         abstract[i] = clause_delete[i] = nxtc[i] = 0;
         int l = clause[i].size();
+        ticks += l;
         for (int j = 0; j < l; j++) {
             if (clause[i][j] > 0) occurp[clause[i][j]].push(i);
             else occurn[-clause[i][j]].push(i);
@@ -39,6 +40,8 @@ int preprocess::search_xors() {
         if (nxtc[i]) continue;
         nxtc[i] = 1;
         int l = clause[i].size();
+        ticks += l;
+        if (out_of_budget()) break;
         if (l <= 2 || l > MAX_XOR) continue;
         int required_num = 1 << (l - 2), skip = 0, mino = clauses + 1, mino_id = 0;
         for (int j = 0; j < l; j++) {
@@ -64,6 +67,7 @@ int preprocess::search_xors() {
             if (!nxtc[o] && clause[o].size() == l && abstract[o] == abstract[i])
                 xorsp.push(o);
         }
+        ticks += 1ll * mino * l;
         if (xorsp.size() < 2 * required_num) continue;
 
         int rhs[2] = {0, 0};
@@ -177,6 +181,9 @@ int preprocess::gauss_elimination() {
         int id = scc_id[abs(clause[xors[xor_scc[i][0]].c][0])];
         assert(scc[id].size() > 3);
         if (scc[id].size() > 1e7 / xor_scc[i].size()) continue;
+        // 消元的代价约为 行数*列数*列数/64，预算不够时不再消元
+        ticks += 1ll * xor_scc[i].size() * (scc[id].size() + 1) * (scc[id].size() / 64 + 1);
+        if (out_of_budget()) break;
         mzd2v.clear();
         std::sort(scc[id].data, scc[id].data + scc[id].size(), cmpvar);
         for (int j = 0; j < scc[id].size(); j++) {
@@ -195,7 +202,6 @@ int preprocess::gauss_elimination() {
                 mzd_write_bit(mat, row, cols - 1, 1); 
         }
         mzd_echelonize(mat, true);
-        mzd_free(mat);
         for (int row = 0, rhs; row < xor_scc[i].size(); row++) {
             vec<int> ones;
             for (int col = 0; col < cols - 1; col++) 
@@ -225,10 +231,12 @@ int preprocess::gauss_elimination() {
                 clause[clauses].push(-q);
             }
             else if (rhs) {
+                mzd_free(mat);
                 return false;
             }
         NextRow:;
         }
+        mzd_free(mat);
     }
     return true;
 }
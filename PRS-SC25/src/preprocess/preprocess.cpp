@@ -1,11 +1,21 @@
 #include "preprocess.hpp"
 #include "utils/parse.hpp"
 #include <chrono>
+#include <climits>
 
 preprocess::preprocess():
   vars                  (0),
   clauses               (0),
-  maxlen                (0)
+  maxlen                (0),
+  res_clauses           (0),
+  resolutions           (0),
+  mapfrom               (nullptr),
+  ticks                 (0),
+  tick_limit            (LLONG_MAX),
+  clock_ticks           (0),
+  aborted               (false),
+  timed_out             (false),
+  interrupted           (false)
 {}
 
 void preprocess::preprocess_init() {
@@ -177,77 +187,85 @@ void preprocess::read_file(const char* filename) {
 }
 
 
-int preprocess::do_preprocess() {
-    int res = 0;
+int preprocess::fixed_vars() {
+    int n = 0;
+    for (int i = 1; i <= orivars; i++)
+        if (!mapto[i] && abs(mapval[i]) == 1) ++n;
+    return n;
+}
 
-    if (vars <= 1e5 && clauses <= 1e6) {
-        res = preprocess_circuit();
-        if (res == 10) {
-            release();
-            return 10;
-        }
-        if (res == 20) {
-            release();
-            return 20;
-        }
-    }
-    
-    if (vars <= 1e5 && clauses <= 1e6) {
-        res = preprocess_gauss();
-        if (!res) {
-            release();
-            return 20;
-        }
+bool preprocess::out_of_budget() {
+    if (aborted) return true;
+    if (interrupted.load(std::memory_order_relaxed)) return aborted = true;
+    if (ticks > tick_limit) return aborted = true;
+    // 读时钟比较慢，每处理约一百万ticks才检查一次
+    if (ticks - clock_ticks >= (1 << 20)) {
+        clock_ticks = ticks;
+        if (std::chrono::steady_clock::now() > deadline) aborted = timed_out = true;
     }
+    return aborted;
+}
 
-    res = preprocess_up();
-    if (!res) {
-        release();
-        delete []mapto;
-        delete []mapval;
-        clause.clear(true);
-        return 20;
+template <typename Pass>
+int preprocess::run_pass(const char* name, int pass_effort, double time_share, Pass pass) {
+    if (!pass_effort || interrupted) return 0;
+    auto now = std::chrono::steady_clock::now();
+    ll literals = 0;
+    for (int i = 1; i <= clauses; i++) literals += clause[i].size();
+    ticks = clock_ticks = 0, aborted = false;
+    // effort小于0的过程(单元传播)不限制
+    tick_limit = pass_effort < 0 ? LLONG_MAX : std::max(effort.min_ticks, pass_effort * literals);
+    deadline = std::chrono::steady_clock::time_point::max();
+    if (pass_effort > 0 && effort.seconds > 0) {
+        double remain = effort.seconds - std::chrono::duration<double>(now - start).count();
+        deadline = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(std::max(0.0, remain) * time_share));
     }
-
-
-    if (vars <= 1e5 && clauses <= 1e6) {
-        res = preprocess_card();
-        if (!res) {
-            release();
-            delete []mapto;
-            delete []mapval;
-            clause.clear(true);
-            res_clause.clear(true);
-            resolution.clear(true);
-            return 20;        
-        }
+    int ovars = vars, oclauses = clauses, ofixed = fixed_vars();
+    int res = pass();
+    if (res < 0) {
+        printf("c pass %-10s skipped\n", name);
+        return 0;
     }
+    double used = std::chrono::duration<double>(std::chrono::steady_clock::now() - now).count();
+    if (res) printf("c pass %-10s %.2fs, %lld ticks, %s\n", name, used, ticks, res == 10 ? "SAT" : "UNSAT");
+    else printf("c pass %-10s %.2fs, %lld ticks, vars %d -> %d (%d fixed), clauses %d -> %d%s\n",
+                name, used, ticks, ovars, vars, fixed_vars() - ofixed, oclauses, clauses,
+                !aborted ? "" : interrupted ? ", interrupted" : ", out of budget");
+    return res;
+}
 
-    res = preprocess_resolution();
-    if (!res) {
-        release();
+// 各过程依次运行，预算按当时的公式大小计算；time_share为该过程可用的剩余时间比例
+int preprocess::do_preprocess() {
+    start = std::chrono::steady_clock::now();
+    timed_out = false;
+    int res = run_pass("circuit", effort.circuit, 0.2, [this] {
+        return preprocess_circuit();
+    });
+    if (!res) res = run_pass("gauss", effort.gauss, 0.2, [this] {
+        return preprocess_gauss() ? 0 : 20;
+    });
+    if (!res) res = run_pass("up", -1, 0, [this] {
+        return preprocess_up() ? 0 : 20;
+    });
+    if (!res) res = run_pass("card", effort.card, 0.2, [this] {
+        int r = preprocess_card();
+        return r < 0 ? -1 : r ? 0 : 20;
+    });
+    if (!res) res = run_pass("resolution", effort.resolution, 0.5, [this] {
+        return preprocess_resolution() ? 0 : 20;
+    });
+    if (!res) res = run_pass("binary", effort.binary, 1.0, [this] {
+        return preprocess_binary() ? 0 : 20;
+    });
+
+    release();
+    if (res == 20) {
         delete []mapto;
         delete []mapval;
         clause.clear(true);
         res_clause.clear(true);
         resolution.clear(true);
-        return 20;
     }
-
-
-    if (clauses <= 1e7) {
-        res = preprocess_binary();
-        if (!res) {
-            release();
-            delete []mapto;
-            delete []mapval;
-            clause.clear(true);
-            res_clause.clear(true);
-            resolution.clear(true);
-            return 20;
-        }
-    }
-    
-    release();
-    return 0;
+    return res;
 }
@@ -6,6 +6,8 @@
 #include "../utils/bitset.hpp"
 #include <queue>
 #include <unordered_set>
+#include <chrono>
+#include <atomic>
 
 typedef long long ll;
 
@@ -57,6 +59,21 @@ struct type_gate {
     }
 };
 
+// 各化简过程的工作量设置，由调用者在do_preprocess之前设置。
+// 每个过程的ticks预算为effort乘以当时公式的文字数(不少于min_ticks)，effort为0时不运行该过程；
+// seconds为整个预处理的时间上限，0为不限，各过程按pass表中的比例分得剩余时间
+struct preprocess_effort {
+    int circuit = 100000, gauss = 1000, card = 1000, resolution = 200, binary = 200;
+    // 基数约束消去的稠密矩阵最多card_size个元素(每行vars+1个)，超过时不运行
+    ll card_size = 50000000;
+    // 变量消去只考虑正负出现次数都不超过elim_occs的变量，消解式长度不超过elim_length
+    int elim_occs = 100, elim_length = 50;
+    // 变量消去的线程数，不影响化简结果
+    int threads = 1;
+    ll min_ticks = 10000000;
+    double seconds = 0;
+};
+
 struct preprocess {
 public:   
     preprocess();
@@ -78,7 +95,13 @@ public:
     vec<int> *occurp, *occurn, clause_delete, nxtc, resolution;
     
     int find(int x);    
-    bool res_is_empty(int var);
+    bool merge_literals(int x, int y);
+    bool binary_scc(int &equivalences, int &units);
+    int  live_occurs(vec<int> &occ);
+    int  compare_marked(int d, int &absent, int &flipped);
+    bool strengthen(int d, int lit);
+    bool resolve_var(int x, vec<int> &lits, vec<int> &ends, ll &work);
+    bool add_resolvent(vec<int> &r, vec<int> &touched);
     void update_var_clause_label();
     void preprocess_init();
     bool preprocess_resolution();
@@ -86,9 +109,27 @@ public:
     bool preprocess_up();
     void get_complete_model();
     int  do_preprocess();
+    int  fixed_vars();
 
     void read_file(const char* filename);
 
+    // pass管理器：按顺序运行各化简过程并输出每个过程的耗时、ticks和化简效果
+    preprocess_effort effort;
+    ll ticks, tick_limit, clock_ticks;
+    std::chrono::steady_clock::time_point start, deadline;
+    bool aborted;
+    // 某个过程因为到达时间上限而结束时置位，直到下一次do_preprocess。
+    // 这时的结果取决于时间限制，不能写入缓存
+    bool timed_out;
+    // 其他线程请求停止时置位，当前过程在下一次检查预算时结束，之后的过程不再运行
+    std::atomic<bool> interrupted;
+    // 当前过程的预算是否用尽。各过程在内层循环中累加ticks，只在能够保持公式一致的位置检查，
+    // 用尽后提前结束，已经完成的化简保留
+    bool out_of_budget();
+    // 返回10/20表示过程已经得出结论，0表示继续；过程返回-1表示公式不适合该过程、没有做任何化简
+    template <typename Pass>
+    int  run_pass(const char* name, int pass_effort, double time_share, Pass pass);
+
     vec<vec<int>> card_one;
     vec<vec<double>> mat;
     vec<int> *occur;
@@ -98,7 +139,7 @@ public:
     int  search_almost_one();    
     int  card_elimination();
     int  scc_almost_one();
-    void upd_occur(int v, int s);
+    int  upd_occur(int v, int s);
 
     int *abstract;
     int gauss_eli_unit;
@@ -121,7 +162,7 @@ public:
     int  find_fa(int x);
     int  preprocess_circuit();
     void epcec_preprocess();
-    bool do_epcec();
+    int  do_epcec();
     bool _simulate(Bitset** result, int bit_size);
 };
 
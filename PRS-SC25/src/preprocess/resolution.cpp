@@ -1,104 +1,306 @@
 #include "preprocess.hpp"
+#include <algorithm>
+#include <thread>
+#include <atomic>
 
-bool preprocess::res_is_empty(int x) {
+// 一轮最多同时消去的变量数，与线程数无关，消去结果不随线程数变化
+#define ELIM_ROUND 4096
+
+// 并行消去时每个线程的消解式缓冲区
+struct elim_buffer {
+    vec<int> lits, ends;
+    ll ticks = 0;
+};
+
+// 从出现列表中去掉已删除的子句，返回剩下的子句个数
+int preprocess::live_occurs(vec<int> &occ) {
+    int t = 0;
+    ticks += occ.size();
+    for (int j = 0; j < occ.size(); j++)
+        if (!clause_delete[occ[j]]) occ[t++] = occ[j];
+    occ.setsize(t);
+    return t;
+}
+
+// 子句d与resseen中标记的子句比较：absent为d中没有标记的文字个数，
+// 返回d中与标记符号相反的文字个数(超过1个时不再统计)，flipped为其中最后一个
+int preprocess::compare_marked(int d, int &absent, int &flipped) {
+    int flips = 0, l = clause[d].size();
+    absent = 0;
+    ticks += l;
+    for (int j = 0; j < l; j++) {
+        int lit = clause[d][j], m = resseen[abs(lit)];
+        if (!m) ++absent;
+        else if (m != pnsign(lit)) {
+            flipped = lit;
+            if (++flips > 1) break;
+        }
+    }
+    return flips;
+}
+
+// 从子句d中去掉文字lit，得到空子句时返回false
+bool preprocess::strengthen(int d, int lit) {
+    int l = clause[d].size();
+    for (int j = 0; j < l; j++)
+        if (clause[d][j] == lit) {
+            clause[d][j] = clause[d][l - 1];
+            break;
+        }
+    clause[d].setsize(l - 1);
+    upd_occur(lit, d);
+    ticks += l;
+    return l > 1;
+}
+
+// 变量x的全部消解式接在lits之后，ends记录每个消解式的结束位置，工作量计入work。
+// 消解式个数超过x所在的子句数或某个消解式过长时返回false，x不消去，缓冲区恢复原状。
+// 只读写x的邻域(x所在子句中的变量)的resseen，邻域互不相交的变量可以在不同线程中同时调用
+bool preprocess::resolve_var(int x, vec<int> &lits, vec<int> &ends, ll &work) {
     int op = occurp[x].size(), on = occurn[x].size();
+    int lits0 = lits.size(), ends0 = ends.size();
     for (int i = 0; i < op; i++) {
         int o1 = occurp[x][i], l1 = clause[o1].size();
-        if (clause_delete[o1]) continue;
         for (int j = 0; j < l1; j++)
             if (abs(clause[o1][j]) != x) resseen[abs(clause[o1][j])] = pnsign(clause[o1][j]);
-        for (int j = 0; j < on; j++) {
-            int o2 = occurn[x][j], l2 = clause[o2].size(), flag = 0;
-            if (clause_delete[o2]) continue;
-            for (int k = 0; k < l2; k++)
-                if (abs(clause[o2][k]) != x && resseen[abs(clause[o2][k])] == -pnsign(clause[o2][k])) {
-                    flag = 1; break;
-                }
-            if (!flag) {
-                for (int j = 0; j < l1; j++)
-                    resseen[abs(clause[o1][j])] = 0;
-                return false;
+        bool ok = true;
+        for (int j = 0; j < on && ok; j++) {
+            int o2 = occurn[x][j], l2 = clause[o2].size(), start = lits.size();
+            work += l1 + l2;
+            for (int k = 0; k < l2; k++) {
+                int lit = clause[o2][k], m = resseen[abs(lit)];
+                if (abs(lit) == x || m == pnsign(lit)) continue;
+                if (m) goto Tautology;
+                lits.push(lit);
             }
+            for (int k = 0; k < l1; k++)
+                if (abs(clause[o1][k]) != x) lits.push(clause[o1][k]);
+            if (lits.size() - start > effort.elim_length || ends.size() - ends0 == op + on) ok = false;
+            ends.push(lits.size());
+            continue;
+        Tautology:
+            lits.setsize(start);
         }
         for (int j = 0; j < l1; j++)
             resseen[abs(clause[o1][j])] = 0;
+        if (!ok) {
+            lits.setsize(lits0), ends.setsize(ends0);
+            return false;
+        }
+    }
+    return true;
+}
+
+// 加入消解式r：先检查r是否被已有子句包含或可以被加强，再用r去包含或加强已有子句。
+// 被包含的子句删除，连同变量消去时删除的子句一起留给get_complete_model恢复模型。
+// 修改过的子句中的变量记入touched，得到空子句时返回false
+bool preprocess::add_resolvent(vec<int> &r, vec<int> &touched) {
+    for (int j = 0; j < r.size(); j++) resseen[abs(r[j])] = pnsign(r[j]);
+    int absent = 0, flipped = 0;
+Forward:
+    for (int j = 0; j < r.size(); j++) {
+        int v = abs(r[j]);
+        vec<int> &occ = r[j] > 0 ? occurp[v] : occurn[v];
+        if (occ.size() > effort.elim_occs) continue;
+        for (int k = 0; k < occ.size(); k++) {
+            int d = occ[k];
+            if (clause_delete[d] || clause[d].size() > r.size()) continue;
+            int flips = compare_marked(d, absent, flipped);
+            if (absent || flips > 1) continue;
+            if (!flips) {
+                for (int i = 0; i < r.size(); i++) resseen[abs(r[i])] = 0;
+                return true;
+            }
+            resseen[abs(flipped)] = 0;
+            for (int i = 0; i < r.size(); i++)
+                if (r[i] == -flipped) { r[i] = r.last(), r.pop(); break; }
+            if (!r.size()) return false;
+            goto Forward;
+        }
+    }
+
+    int id = ++clauses, best = 0;
+    clause.push();
+    clause_delete.growTo(clauses + 1, 0);
+    clause_delete[id] = 0;
+    nxtc.growTo(clauses + 1, 0);
+    for (int j = 0; j < r.size(); j++) {
+        int v = abs(r[j]);
+        clause[id].push(r[j]);
+        if (r[j] > 0) occurp[v].push(id);
+        else occurn[v].push(id);
+        if (!best || occurp[v].size() + occurn[v].size() < occurp[best].size() + occurn[best].size()) best = v;
+        if (seen[v] != seen[0]) seen[v] = seen[0], touched.push(v);
+    }
+    if (r.size() > maxlen) {
+        maxlen = r.size();
+        delete []a;
+        a = new int[maxlen + 1];
     }
-    return true; 
+
+    // 被r包含或加强的子句一定含有r中出现次数最少的变量
+    for (int s = 0; s < 2; s++) {
+        vec<int> &occ = s ? occurn[best] : occurp[best];
+        for (int k = 0; k < occ.size(); k++) {
+            int d = occ[k];
+            if (d == id || clause_delete[d] || clause[d].size() < r.size()) continue;
+            int flips = compare_marked(d, absent, flipped);
+            if (flips > 1 || clause[d].size() - absent != r.size()) continue;
+            for (int j = 0; j < clause[d].size(); j++) {
+                int v = abs(clause[d][j]);
+                if (seen[v] != seen[0]) seen[v] = seen[0], touched.push(v);
+            }
+            if (!flips) clause_delete[d] = 1;
+            else {
+                if (abs(flipped) == best) --k;
+                if (!strengthen(d, flipped)) return false;
+            }
+        }
+    }
+    for (int j = 0; j < r.size(); j++) resseen[abs(r[j])] = 0;
+    return true;
 }
 
-bool preprocess::preprocess_resolution() {    
+// 有界变量消去：按op*on从小到大尝试消去变量，消解式个数不超过原来的子句数时
+// 删除变量所在的子句并加入消解式。消去的变量按顺序放入q，删除的子句留作恢复模型。
+// 每一轮按代价顺序贪心地选出邻域互不相交的一组变量，由effort.threads个线程同时求消解式，
+// 再按选出的顺序依次删除子句、加入消解式并做包含检查。一个变量的消解式只含它邻域中的变量，
+// 包含检查改动的子句都含有这些变量，不会影响同一轮中其他变量的消解式
+bool preprocess::preprocess_resolution() {
     for (int i = 1; i <= vars; i++) {
         occurn[i].clear();
         occurp[i].clear();
         resseen[i]= clean[i] = seen[i] = 0;
     }
     for (int i = 1; i <= clauses; i++) {
-        int l = clause[i].size();
+        int l = clause[i].size(), t = 0;
         clause_delete[i] = 0;
+        ticks += l;
+        // 去掉重复的文字，重言式直接删除
+        for (int j = 0; j < l; j++) {
+            int lit = clause[i][j], m = resseen[abs(lit)];
+            if (m == pnsign(lit)) continue;
+            if (m) clause_delete[i] = 1;
+            resseen[abs(lit)] = pnsign(lit), clause[i][t++] = lit;
+        }
+        for (int j = 0; j < t; j++) resseen[abs(clause[i][j])] = 0;
+        clause[i].setsize(l = t);
         for (int j = 0; j < l; j++) {
             if (clause[i][j] > 0) occurp[abs(clause[i][j])].push(i);
             else occurn[abs(clause[i][j])].push(i);
         }
     }
-    for (int i = 1; i <= vars; i++)
-        if (occurn[i].size() == 0 && occurp[i].size() == 0) clean[i] = 1;  
 
-    int l = 1, r = 0;         
+    // seen[0]为当前的标记，touched中是子句有变化、需要重新计算代价的变量
+    typedef std::pair<ll, int> candidate;
+    std::priority_queue<candidate, std::vector<candidate>, std::greater<candidate>> heap;
+    vec<int> touched, res, batch, deferred, owner, first, last, lock(vars + 1, 0);
+    int threads = std::max(1, effort.threads), round = 0;
+    elim_buffer *buffers = new elim_buffer[threads];
+    seen[0] = 0;
     for (int i = 1; i <= vars; i++) {
-        int op = occurp[i].size(), on = occurn[i].size();
-        if (op * on > op + on || clean[i]) continue;
-        if (res_is_empty(i)) {
-            q[++r] = i, clean[i] = 1;
-        }
+        if (occurn[i].size() == 0 && occurp[i].size() == 0) clean[i] = 1;
+        else heap.push(candidate(1ll * live_occurs(occurp[i]) * live_occurs(occurn[i]), i));
     }
-    
-    int now_turn = 0, seen_flag = 0;
-    vec<int> vars;
-    while (l <= r) {
-        ++now_turn;
-        for (int j = l; j <= r; j++) {
-            int i = q[j];
-            int op = occurp[i].size(), on = occurn[i].size();
-            for (int j = 0; j < op; j++) clause_delete[occurp[i][j]] = 1;
-            for (int j = 0; j < on; j++) clause_delete[occurn[i][j]] = 1;
+
+    int eliminated = 0;
+    while (!heap.empty()) {
+        if (out_of_budget()) break;
+        // 选出本轮的变量，邻域与已选变量相交的留到下一轮，冲突多于选中的变量时结束本轮
+        ++round;
+        batch.clear(), deferred.clear();
+        while (!heap.empty() && batch.size() < ELIM_ROUND && deferred.size() <= batch.size() + 16) {
+            candidate c = heap.top();
+            heap.pop();
+            int x = c.second;
+            if (clean[x]) continue;
+            int op = live_occurs(occurp[x]), on = live_occurs(occurn[x]);
+            if (1ll * op * on != c.first) continue;
+            if (op && on && (op > effort.elim_occs || on > effort.elim_occs)) continue;
+            bool independent = lock[x] != round;
+            for (int s = 0; s < 2 && independent; s++) {
+                vec<int> &occ = s ? occurn[x] : occurp[x];
+                for (int k = 0; k < occ.size() && independent; k++) {
+                    ticks += clause[occ[k]].size();
+                    for (int j = 0; j < clause[occ[k]].size(); j++)
+                        if (lock[abs(clause[occ[k]][j])] == round) { independent = false; break; }
+                }
+            }
+            if (!independent) { deferred.push(x); continue; }
+            lock[x] = round;
+            for (int s = 0; s < 2; s++) {
+                vec<int> &occ = s ? occurn[x] : occurp[x];
+                for (int k = 0; k < occ.size(); k++)
+                    for (int j = 0; j < clause[occ[k]].size(); j++)
+                        lock[abs(clause[occ[k]][j])] = round;
+            }
+            batch.push(x);
+        }
+        for (int k = 0; k < deferred.size(); k++) {
+            int x = deferred[k];
+            heap.push(candidate(1ll * occurp[x].size() * occurn[x].size(), x));
         }
-        int ll = l; l = r + 1;
-        
-        vars.clear();
-        ++seen_flag;
-        for (int u = ll; u <= r; u++) {
-            int i = q[u];
-            int op = occurp[i].size(), on = occurn[i].size();
-            for (int j = 0; j < op; j++) {
-                int o = occurp[i][j], l = clause[o].size();
-                for (int k = 0; k < l; k++) {
-                    int v = abs(clause[o][k]);
-                    if (!clean[v] && seen[v] != seen_flag)
-                        vars.push(v), seen[v] = seen_flag;
+
+        // 各线程领取变量求消解式，owner为结果所在的缓冲区，first/last为消解式的编号范围(last为-1表示不消去)
+        owner.growTo(batch.size()), first.growTo(batch.size()), last.growTo(batch.size());
+        for (int t = 0; t < threads; t++)
+            buffers[t].lits.clear(), buffers[t].ends.clear();
+        std::atomic<int> next(0);
+        auto work = [&](int t) {
+            elim_buffer &b = buffers[t];
+            for (int i; (i = next++) < batch.size(); ) {
+                owner[i] = t, first[i] = b.ends.size();
+                last[i] = resolve_var(batch[i], b.lits, b.ends, b.ticks) ? b.ends.size() : -1;
+            }
+        };
+        // 变量太少时创建线程的开销比求消解式还大，每个线程至少分到256个变量
+        int helpers = std::min(threads, batch.size() / 256) - 1;
+        std::vector<std::thread> workers;
+        for (int t = 1; t <= helpers; t++) workers.emplace_back(work, t);
+        work(0);
+        for (auto &w : workers) w.join();
+        for (int t = 0; t < threads; t++)
+            ticks += buffers[t].ticks, buffers[t].ticks = 0;
+
+        for (int i = 0; i < batch.size(); i++) {
+            if (last[i] < 0) continue;
+            int x = batch[i];
+            elim_buffer &b = buffers[owner[i]];
+            q[++eliminated] = x, clean[x] = 1;
+            touched.clear();
+            ++seen[0];
+            for (int s = 0; s < 2; s++) {
+                vec<int> &occ = s ? occurn[x] : occurp[x];
+                for (int k = 0; k < occ.size(); k++) {
+                    int o = occ[k];
+                    clause_delete[o] = 1;
+                    for (int j = 0; j < clause[o].size(); j++) {
+                        int v = abs(clause[o][j]);
+                        if (seen[v] != seen[0]) seen[v] = seen[0], touched.push(v);
+                    }
                 }
             }
-            for (int j = 0; j < on; j++) {
-                int o = occurn[i][j], l = clause[o].size();
-                for (int k = 0; k < l; k++) {
-                    int v = abs(clause[o][k]);
-                    if (!clean[v] && seen[v] != seen_flag)
-                        vars.push(v), seen[v] = seen_flag;
+            for (int k = first[i]; k < last[i]; k++) {
+                res.clear();
+                for (int j = k ? b.ends[k - 1] : 0; j < b.ends[k]; j++) res.push(b.lits[j]);
+                if (!add_resolvent(res, touched)) {
+                    delete []buffers;
+                    return false;
                 }
             }
-        }
-        for (int u = 0; u < vars.size(); u++) {
-            int i = vars[u];
-            int op = 0, on = 0;
-            for (int j = 0; j < occurp[i].size(); j++) op += 1 - clause_delete[occurp[i][j]];
-            for (int j = 0; j < occurn[i].size(); j++) on += 1 - clause_delete[occurn[i][j]];
-            if (op * on > op + on) { continue;}
-            if (res_is_empty(i)) {
-                q[++r] = i, clean[i] = 1;
+            for (int k = 0; k < touched.size(); k++) {
+                int v = touched[k];
+                if (clean[v]) continue;
+                heap.push(candidate(1ll * live_occurs(occurp[v]) * live_occurs(occurn[v]), v));
             }
         }
     }
-    vars.clear(true);
-    if (!r) return true;
+    delete []buffers;
+    // 子句已全部删除的变量也要放入消去序列，否则恢复模型时没有取值
+    for (int i = 1; i <= vars; i++)
+        if (!clean[i] && !live_occurs(occurp[i]) && !live_occurs(occurn[i]))
+            q[++eliminated] = i, clean[i] = 1;
+    if (!eliminated) return true;
     res_clauses = 0;
     res_clause.push();
     for (int i = 1; i <= clauses; i++) {
@@ -110,9 +312,9 @@ bool preprocess::preprocess_resolution() {
             res_clause[res_clauses].push(pnsign(clause[i][j]) * mapfrom[abs(clause[i][j])]);
         }
     }
-    resolutions = r;
+    resolutions = eliminated;
     resolution.push();
-    for (int i = 1; i <= r; i++) {
+    for (int i = 1; i <= eliminated; i++) {
         int v = mapfrom[q[i]];
         resolution.push(v);
         mapto[v] = 0, mapval[v] = -10;
@@ -124,4 +326,4 @@ bool preprocess::preprocess_resolution() {
         }
     }
     return true;
-}
\ No newline at end of file
+}
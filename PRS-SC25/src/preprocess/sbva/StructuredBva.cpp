@@ -176,6 +176,23 @@ int StructuredBVA::leastFrequentLiteral(simpleClause &clause, int elit)
 }
 
 void StructuredBVA::addInitialClauses(const std::vector<simpleClause> &initClauses, unsigned nbVariables)
+{
+    this->loadInitialClauses(
+        initClauses.size(),
+        [&initClauses](unsigned i, simpleClause &clause) { clause = initClauses[i]; },
+        nbVariables);
+}
+
+void StructuredBVA::addInitialClauses(const Formula &formula, unsigned nbVariables)
+{
+    this->loadInitialClauses(
+        formula.size(),
+        [&formula](unsigned i, simpleClause &clause) { clause.assign(formula.begin(i), formula.end(i)); },
+        nbVariables);
+}
+
+template <class ClauseAt>
+void StructuredBVA::loadInitialClauses(unsigned nbClauses, ClauseAt clauseAt, unsigned nbVariables)
 {
     // if (initClauses.size() > Parameters::getIntParam("sbva-max-clause", MILLION * 10))
     // {
@@ -183,9 +200,11 @@ void StructuredBVA::addInitialClauses(const std::vector<simpleClause> &initClaus
     //     this->initialized = false;
     //     return;
     // }
-    std::unordered_set<simpleClause, clauseHash> clausesCache;
+    /* The cache holds indexes into this->clauses instead of a second copy of every clause */
+    auto hashIdx = [this](unsigned idx) { return clauseHash()(this->clauses[idx]); };
+    auto equalIdx = [this](unsigned a, unsigned b) { return this->clauses[a] == this->clauses[b]; };
+    std::unordered_set<unsigned, decltype(hashIdx), decltype(equalIdx)> clausesCache(nbClauses, hashIdx, equalIdx);
     unsigned duplicatesCount = 0;
-    unsigned nbClauses = initClauses.size();
     simpleClause tmpClause;
     unsigned actualIdx = 0; /* since duplicates may exists */
 
@@ -196,21 +215,21 @@ void StructuredBVA::addInitialClauses(const std::vector<simpleClause> &initClaus
 
     for (unsigned i = 0; i < nbClauses && !this->stopPreprocessing; i++)
     {
-        tmpClause = initClauses[i];
+        clauseAt(i, tmpClause);
         std::sort(tmpClause.begin(), tmpClause.end());
-        auto insertTest = clausesCache.insert(tmpClause);
-        if (!insertTest.second)
+        this->clauses.push_back(std::move(tmpClause));
+        if (!clausesCache.insert(actualIdx).second)
         {
+            this->clauses.pop_back();
             duplicatesCount++;
             continue;
         }
         else
         {
-            for (int lit : tmpClause)
+            for (int lit : this->clauses[actualIdx])
             {
                 this->litToClause[LIT_IDX(lit)].push_back(actualIdx);
             }
-            this->clauses.push_back(std::move(tmpClause));
             this->isClauseDeleted.push_back(0);
             actualIdx++;
         }
@@ -26,6 +26,7 @@
 
 #include "PreprocessInterface.h"
 #include "Entity.hpp"
+#include "utils/formula.hpp"
 
 typedef std::vector<int> simpleClause;
 
@@ -122,6 +123,9 @@ public:
 
     void addInitialClauses(const std::vector<simpleClause> &clauses, unsigned nbVariables);
 
+    /// Same as above, reading the clauses directly from the shared CSR formula
+    void addInitialClauses(const Formula &formula, unsigned nbVariables);
+
     void printStatistics();
 
     std::vector<simpleClause> getClauses();
@@ -223,6 +227,10 @@ public:
     }
 
 private:
+    /// @brief Loads nbClauses clauses, clauseAt(i, clause) fills the i-th one
+    template <class ClauseAt>
+    void loadInitialClauses(unsigned nbClauses, ClauseAt clauseAt, unsigned nbVariables);
+
     std::atomic<bool> stopPreprocessing;
 
     /// @brief Vector of clauses
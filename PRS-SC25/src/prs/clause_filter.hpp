@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include "preprocess/sbva/BloomFilter.h"
+
+// 共享子句去重过滤器：无锁的布隆过滤器，以与文字顺序无关的子句哈希为键。
+// 使用两代位图轮换老化，插入过多后丢弃旧的一代，避免误判率持续升高
+class ClauseFilter {
+public:
+    static const int LOG_BITS = 22;
+    static const int HASHES = 3;
+
+    ClauseFilter() {
+        for (int g = 0; g < 2; g++) {
+            bits[g] = new std::atomic<uint64_t>[WORDS];
+            for (size_t i = 0; i < WORDS; i++) bits[g][i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ~ClauseFilter() {
+        delete[] bits[0];
+        delete[] bits[1];
+    }
+
+    // 子句哈希，文字的排列不影响结果
+    static uint64_t hash(const int* lits, int size) {
+        uint64_t h = lookup3_hash_clause(const_cast<int*>(lits), size);
+        return h * 0x9e3779b97f4a7c15ull + size;
+    }
+
+    // 是否已经见过该子句（任意一代中出现即视为重复）
+    bool contains(uint64_t h) const {
+        return test(bits[current.load(std::memory_order_acquire)], h) ||
+               test(bits[current.load(std::memory_order_acquire) ^ 1], h);
+    }
+
+    // 记录子句，写满一代后轮换
+    void insert(uint64_t h) {
+        std::atomic<uint64_t>* b = bits[current.load(std::memory_order_acquire)];
+        for (int k = 0; k < HASHES; k++) {
+            size_t bit = position(h, k);
+            b[bit >> 6].fetch_or(1ull << (bit & 63), std::memory_order_relaxed);
+        }
+        if (inserted.fetch_add(1, std::memory_order_relaxed) + 1 >= CAPACITY) rotate();
+    }
+
+private:
+    static const size_t BITS = 1ull << LOG_BITS;
+    static const size_t WORDS = BITS >> 6;
+    // 每一代最多插入的子句数，保证单代误判率在0.5%左右
+    static const size_t CAPACITY = BITS >> 4;
+
+    static size_t position(uint64_t h, int k) {
+        uint64_t h1 = h, h2 = (h >> 32) | 1;
+        return (h1 + k * h2) & (BITS - 1);
+    }
+
+    static bool test(const std::atomic<uint64_t>* b, uint64_t h) {
+        for (int k = 0; k < HASHES; k++) {
+            size_t bit = position(h, k);
+            if (!(b[bit >> 6].load(std::memory_order_relaxed) & (1ull << (bit & 63)))) return false;
+        }
+        return true;
+    }
+
+    // 清空较旧的一代并让它成为当前代
+    void rotate() {
+        int old = current.load(std::memory_order_relaxed) ^ 1;
+        for (size_t i = 0; i < WORDS; i++) bits[old][i].store(0, std::memory_order_relaxed);
+        current.store(old, std::memory_order_release);
+        inserted.store(0, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t>* bits[2];
+    std::atomic<int> current{0};
+    std::atomic<size_t> inserted{0};
+};
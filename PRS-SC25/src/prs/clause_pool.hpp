@@ -0,0 +1,177 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+// 共享子句池：分享线程是唯一的写者，把子句连续写入大块slab中；
+// 每个消费者只持有一个(slab, offset)游标，不需要引用计数。
+// slab按epoch编号，所有消费者的游标都越过之后由写者回收复用。
+//
+// 子句记录格式: [producer, lbd, size, targets[words], lit_1, ..., lit_size]，
+// targets是接收该子句的消费者位图，由分享拓扑决定
+class ClausePool {
+public:
+    static const int SLAB_INTS = 1 << 16;
+
+    ClausePool(int consumers) : cursors(consumers) {
+        words = (consumers + 31) / 32;
+        header = 3 + words;
+        head = tail = new_slab(SLAB_INTS);
+        for (auto& cursor : cursors) {
+            cursor.slab = tail;
+            cursor.offset = 0;
+            cursor.epoch.store(tail->epoch, std::memory_order_relaxed);
+        }
+    }
+
+    ~ClausePool() {
+        while (head) {
+            Slab* next = head->next.load(std::memory_order_relaxed);
+            delete_slab(head);
+            head = next;
+        }
+        for (auto slab : free_slabs) delete_slab(slab);
+    }
+
+    // 消费者位图占用的int数
+    int target_words() const {
+        return words;
+    }
+
+    // 记录中文字的起始位置
+    const int* literals(const int* rec) const {
+        return rec + header;
+    }
+
+    // 写者：追加一条子句，在flush之前对消费者不可见
+    void publish(int producer, int lbd, int size, const int* lits, const unsigned* targets) {
+        int need = header + size;
+        if (pending + need > tail->capacity) {
+            flush();
+            Slab* slab = new_slab(std::max(SLAB_INTS, need));
+            tail->next.store(slab, std::memory_order_release);
+            tail = slab;
+            pending = 0;
+            reclaim();
+        }
+        int* p = tail->data + pending;
+        p[0] = producer, p[1] = lbd, p[2] = size;
+        memcpy(p + 3, targets, sizeof(int) * words);
+        memcpy(p + header, lits, sizeof(int) * size);
+        pending += need;
+    }
+
+    // 写者：发布已追加的子句
+    void flush() {
+        tail->used.store(pending, std::memory_order_release);
+    }
+
+    // 消费者：返回下一条发给自己的子句，没有新子句时返回nullptr。
+    // 返回的记录在同一消费者下一次调用next之前保持有效
+    const int* next(int consumer) {
+        Cursor& cursor = cursors[consumer];
+        if (cursor.state.load(std::memory_order_relaxed) != ACTIVE) activate(cursor);
+        while (true) {
+            Slab* slab = cursor.slab;
+            Slab* next = slab->next.load(std::memory_order_acquire);
+            int used = slab->used.load(std::memory_order_acquire);
+            while (cursor.offset < used) {
+                const int* rec = slab->data + cursor.offset;
+                cursor.offset += header + rec[2];
+                if ((unsigned)rec[3 + consumer / 32] >> (consumer & 31) & 1) return rec;
+            }
+            if (!next) return nullptr;
+            cursor.slab = next;
+            cursor.offset = 0;
+            cursor.epoch.store(next->epoch, std::memory_order_release);
+        }
+    }
+
+    // 当前仍被持有的slab数目
+    int live_slabs() const {
+        return tail->epoch - head->epoch + 1;
+    }
+
+private:
+    enum { IDLE, MOVING, ACTIVE };
+
+    struct Slab {
+        std::atomic<int> used{0};
+        std::atomic<Slab*> next{nullptr};
+        uint64_t epoch = 0;
+        int capacity = 0;
+        int* data = nullptr;
+    };
+
+    struct alignas(64) Cursor {
+        Slab* slab = nullptr;
+        int offset = 0;
+        std::atomic<uint64_t> epoch{0};
+        std::atomic<int> state{IDLE};
+    };
+
+    Slab* new_slab(int capacity) {
+        Slab* slab = nullptr;
+        if (capacity == SLAB_INTS && !free_slabs.empty()) {
+            slab = free_slabs.back();
+            free_slabs.pop_back();
+            slab->used.store(0, std::memory_order_relaxed);
+            slab->next.store(nullptr, std::memory_order_relaxed);
+        } else {
+            slab = new Slab();
+            slab->capacity = capacity;
+            slab->data = new int[capacity];
+        }
+        slab->epoch = next_epoch++;
+        return slab;
+    }
+
+    void delete_slab(Slab* slab) {
+        delete[] slab->data;
+        delete slab;
+    }
+
+    // 消费者第一次读取时接管自己的游标
+    void activate(Cursor& cursor) {
+        int expected = IDLE;
+        while (!cursor.state.compare_exchange_weak(expected, ACTIVE, std::memory_order_acquire)) {
+            expected = IDLE;
+        }
+    }
+
+    // 回收所有消费者都已经越过的slab。尚未开始读取的消费者直接跳到最新的slab，
+    // 避免还没启动的求解器拖住整个池
+    void reclaim() {
+        uint64_t min_epoch = tail->epoch;
+        for (auto& cursor : cursors) {
+            int expected = IDLE;
+            if (cursor.state.compare_exchange_strong(expected, MOVING, std::memory_order_acquire)) {
+                cursor.slab = tail;
+                cursor.offset = 0;
+                cursor.epoch.store(tail->epoch, std::memory_order_relaxed);
+                cursor.state.store(IDLE, std::memory_order_release);
+            }
+            min_epoch = std::min(min_epoch, cursor.epoch.load(std::memory_order_acquire));
+        }
+        while (head != tail && head->epoch < min_epoch) {
+            Slab* next = head->next.load(std::memory_order_relaxed);
+            if (head->capacity == SLAB_INTS && free_slabs.size() < 4) free_slabs.push_back(head);
+            else delete_slab(head);
+            head = next;
+        }
+    }
+
+    std::vector<Cursor> cursors;
+    int words = 0;
+    int header = 0;
+
+    // 以下成员只由写者访问
+    Slab* head = nullptr;
+    Slab* tail = nullptr;
+    int pending = 0;
+    uint64_t next_epoch = 0;
+    std::vector<Slab*> free_slabs;
+};
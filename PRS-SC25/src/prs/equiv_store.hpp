@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+// 全局等价文字表：外部变量上的无锁并查集，所有求解器直接写入。
+// parent[v]编码为(父变量 << 1 | 奇偶)，奇偶为1表示v与父变量取反等价，
+// 根节点总是集合中编号最小的变量。每次成功合并都追加到只追加的日志中，
+// 日志长度即epoch，求解器只需比较epoch就知道是否有新的等价关系
+class EquivalenceStore {
+public:
+    EquivalenceStore(int vars) : parent(vars + 1), merges(vars + 1) {
+        for (int v = 0; v <= vars; v++) parent[v].store((unsigned)v << 1, std::memory_order_relaxed);
+    }
+
+    // 记录lit和other等价，返回是否合并了两个不同的集合。
+    // 已知等价、超出变量范围或与已知关系矛盾时返回false
+    bool add(int lit, int other) {
+        int a = abs(lit), b = abs(other);
+        if (a == 0 || b == 0 || a >= parent.size() || b >= parent.size()) return false;
+        unsigned parity = (lit < 0) ^ (other < 0);
+        while (true) {
+            unsigned pa, pb;
+            int ra = find(a, pa), rb = find(b, pb);
+            if (ra == rb) return false;
+            unsigned link = pa ^ pb ^ parity;
+            // 编号较大的根挂到编号较小的根下面
+            int hi = ra > rb ? ra : rb, lo = ra > rb ? rb : ra;
+            unsigned expected = (unsigned)hi << 1;
+            if (!parent[hi].compare_exchange_strong(expected, (unsigned)lo << 1 | link,
+                                                    std::memory_order_acq_rel)) continue;
+            int from = link ? -hi : hi;
+            unsigned slot = reserved.fetch_add(1, std::memory_order_acq_rel);
+            merges[slot].store(pack(from, lo), std::memory_order_release);
+            return true;
+        }
+    }
+
+    // 已预留的合并数，单调递增
+    unsigned epoch() const {
+        return reserved.load(std::memory_order_acquire);
+    }
+
+    // 第index次合并，返回false表示写入尚未完成；lit与other等价
+    bool get(unsigned index, int& lit, int& other) const {
+        uint64_t m = merges[index].load(std::memory_order_acquire);
+        if (!m) return false;
+        lit = (int)(uint32_t)(m >> 32);
+        other = (int)(uint32_t)m;
+        return true;
+    }
+
+    // lit所在集合的代表文字
+    int representative(int lit) {
+        unsigned p;
+        int r = find(abs(lit), p);
+        return (lit < 0) ^ p ? -r : r;
+    }
+
+    static void static_export_callback(void* state, int lit, int other) {
+        static_cast<EquivalenceStore*>(state)->add(lit, other);
+    }
+
+    static unsigned static_epoch_callback(void* state) {
+        return static_cast<EquivalenceStore*>(state)->epoch();
+    }
+
+    static int static_import_callback(void* state, unsigned index, int* lit, int* other) {
+        return static_cast<EquivalenceStore*>(state)->get(index, *lit, *other);
+    }
+
+private:
+    static uint64_t pack(int lit, int other) {
+        return (uint64_t)(uint32_t)lit << 32 | (uint32_t)other;
+    }
+
+    // 查找根并累计奇偶，顺带做路径减半
+    int find(int v, unsigned& parity) {
+        parity = 0;
+        while (true) {
+            unsigned pv = parent[v].load(std::memory_order_acquire);
+            int u = pv >> 1;
+            if (u == v) return v;
+            unsigned pu = parent[u].load(std::memory_order_acquire);
+            int w = pu >> 1;
+            if (w != u) {
+                // v直接指向祖父节点，奇偶相加
+                unsigned halved = (unsigned)w << 1 | ((pv ^ pu) & 1);
+                unsigned expected = pv;
+                parent[v].compare_exchange_weak(expected, halved, std::memory_order_acq_rel);
+            }
+            parity ^= pv & 1;
+            v = u;
+        }
+    }
+
+    std::vector<std::atomic<unsigned>> parent;
+    std::vector<std::atomic<uint64_t>> merges;
+    std::atomic<unsigned> reserved{0};
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <cstdio>
 #include <cstring>
 #include <unordered_map>
 
@@ -14,8 +15,54 @@ OPTION( yalsat            , int     , 'y'   , false  , 1       , 0    , 1
 OPTION( share_lits        , int     , '\0'  , false  , 1500    , 0    , 1e18    , "shared lits limit per thread per share_intv") \
 OPTION( share_intv        , int     , '\0'  , false  , 500     , 0    , 1e18    , "share interval(miliseconds)") \
 OPTION( share_grps        , int     , '\0'  , false  , 4       , 1    , 256     , "max share group size") \
+OPTION( share_dup         , int     , '\0'  , false  , 1       , 0    , 1       , "filter duplicate shared clauses") \
+OPTION( share_topo        , int     , '\0'  , false  , 1       , 0    , 3       , "share topology: 0 all, 1 static groups, 2 ring, 3 diversity groups") \
+OPTION( share_xgrp        , int     , '\0'  , false  , 25      , 0    , 100     , "cross-group share budget (percent of share_lits)") \
+OPTION( share_rgrp        , int     , '\0'  , false  , 20      , 1    , 1e9     , "regroup every share_rgrp share rounds") \
+OPTION( share_unit        , int     , '\0'  , false  , 1       , 0    , 1       , "share units through the global unit store") \
+OPTION( share_equiv       , int     , '\0'  , false  , 1       , 0    , 1       , "share literal equivalences and substitute them") \
+OPTION( share_mask        , int     , '\0'  , false  , 1       , 0    , 1       , "skip consumers that eliminated or fixed a variable of the clause") \
+OPTION( share_use         , int     , '\0'  , false  , 1       , 0    , 1       , "steer sharing budgets by usefulness of imported clauses") \
+OPTION( clone             , int     , '\0'  , false  , 1       , 0    , 1       , "load the formula into one kissat/yalsat instance and clone the others from it") \
+OPTION( loaders           , int     , '\0'  , false  , 8       , 0    , 256     , "max solvers loading the formula at the same time (0 for no limit)") \
+OPTION( cache             , std::string, '\0', false , ""      , 0    , 0       , "cache directory for preprocessed formulas (empty to disable)") \
+OPTION( pipeline          , int     , '\0'  , false  , 0       , 0    , 256     , "kissat instances solving the original formula while preprocessing runs (0 to disable)") \
+OPTION( pp_time           , double  , '\0'  , false  , 10.0    , 0.0  , 100.0   , "preprocessing time limit (percent of cutoff, 0 for no limit)") \
+OPTION( pp_circuit        , int     , '\0'  , false  , 100000  , 0    , 1e9     , "circuit equivalence checking effort (ticks per literal, 0 to disable)") \
+OPTION( pp_gauss          , int     , '\0'  , false  , 1000    , 0    , 1e9     , "gauss elimination effort (ticks per literal, 0 to disable)") \
+OPTION( pp_card           , int     , '\0'  , false  , 1000    , 0    , 1e9     , "cardinality elimination effort (ticks per literal, 0 to disable)") \
+OPTION( pp_card_size      , int     , '\0'  , false  , 50000000, 1    , 1e9     , "cardinality elimination matrix size limit (entries)") \
+OPTION( pp_elim           , int     , '\0'  , false  , 200     , 0    , 1e9     , "resolution elimination effort (ticks per literal, 0 to disable)") \
+OPTION( pp_elim_occs      , int     , '\0'  , false  , 100     , 0    , 1e9     , "resolution elimination occurrence limit per polarity") \
+OPTION( pp_elim_length    , int     , '\0'  , false  , 50      , 1    , 1e9     , "resolution elimination resolvent size limit") \
+OPTION( pp_threads        , int     , '\0'  , false  , 4       , 1    , 256     , "threads for resolution elimination, capped by the idle cores") \
+OPTION( pp_binary         , int     , '\0'  , false  , 200     , 0    , 1e9     , "binary equivalence reasoning effort (ticks per literal, 0 to disable)") \
 OPTION( mode              , int     , '\0'  , true   , 0       , 0    , 1       , "0 for PRS, 1 for SBVA")
 
+// 按选项类型注册和打印，字符串选项没有取值范围
+template <typename T>
+inline void add_option(cmdline::parser& parser, const char* name, char short_name, const char* comment,
+                       bool must, T def, double low, double high) {
+    parser.add<T>(name, short_name, comment, must, def, cmdline::range((T)low, (T)high));
+}
+
+inline void add_option(cmdline::parser& parser, const char* name, char short_name, const char* comment,
+                       bool must, const std::string& def, double, double) {
+    parser.add<std::string>(name, short_name, comment, must, def);
+}
+
+inline void print_option(const char* name, const char* type, int now, const char* def, const char* comment) {
+    printf("c %-15s\t %-8s\t %-10d\t %-10s\t %s\n", name, type, now, def, comment);
+}
+
+inline void print_option(const char* name, const char* type, double now, const char* def, const char* comment) {
+    printf("c %-15s\t %-8s\t %-10.2f\t %-10s\t %s\n", name, type, now, def, comment);
+}
+
+inline void print_option(const char* name, const char* type, const std::string& now, const char* def, const char* comment) {
+    printf("c %-15s\t %-8s\t %-10s\t %-10s\t %s\n", name, type, now.c_str(), def, comment);
+}
+
 class Options
 {
 public:
@@ -31,8 +78,7 @@ void parse_args(int argc, char *argv[]) {
     cmdline::parser parser;
 
     #define OPTION(N, T, S, M, D, L, H, C) \
-    if (!strcmp(#T, "int")) parser.add<int>(#N, S, C, M, D, cmdline::range((int)L, (int)H)); \
-    if (!strcmp(#T, "double")) parser.add<double>(#N, S, C, M, D, cmdline::range((double)L, (double)H));
+    add_option(parser, #N, S, C, M, (T)(D), L, H);
     OPTIONS
     #undef OPTION
 
@@ -47,8 +93,7 @@ void parse_args(int argc, char *argv[]) {
     filename = parser.rest()[0];
 
     #define OPTION(N, T, S, M, D, L, H, C) \
-    if (!strcmp(#T, "int")) N = parser.get<int>(#N); \
-    if (!strcmp(#T, "double")) N = parser.get<double>(#N);
+    N = parser.get<T>(#N);
     OPTIONS
     #undef OPTION
 }
@@ -58,8 +103,7 @@ void print_change() {
            "Name", "Type", "Now", "Default", "Comment");
 
 #define OPTION(N, T, S, M, D, L, H, C) \
-    if (strcmp(#T, "int") == 0) printf("c %-15s\t %-8s\t %-10d\t %-10s\t %s\n", (#N), (#T), (int)this->N, (#D), (C)); \
-    if (strcmp(#T, "double") == 0) printf("c %-15s\t %-8s\t %-10.2f\t %-10s\t %s\n", (#N), (#T), (double)this->N, (#D), (C));
+    print_option(#N, #T, this->N, #D, C);
     OPTIONS
 #undef OPTION
     printf("c -----------------------------------------------------------------------------------------------------\n");
@@ -1,4 +1,6 @@
 #include "preprocess/preprocess.hpp"
+#include "preprocess/cache.hpp"
+#include "utils/formula.hpp"
 #include "options.hpp"
 #include <thread>
 #include <vector>
@@ -8,6 +10,7 @@
 #include <memory>
 #include <chrono>
 #include <future>
+#include <sys/resource.h>
 #include "solvers/yalsat.hpp"
 #include "preprocess/sbva/StructuredBva.hpp"
 
@@ -17,19 +20,36 @@ private:
     // 用于线程间共享状态
     std::mutex model_mutex;
     std::atomic<bool> preprocess_completed;
+    // 流水线模式下求解器先得出结果时置位，预处理和局部搜索尽快结束，结果作废
+    std::atomic<bool> terminated;
+    bool loaded = false;
+    // 预处理后的公式和SBVA化简后的公式，构建后只读
+    Formula simplified, sbva_simplified;
     std::vector<std::unique_ptr<YalsatSolver>> yalsat_solvers;
+    std::unique_ptr<PreprocessCache> cache;
+    // 预处理期间留给在原始公式上求解的kissat的线程数，局部搜索少用这么多线程
+    int reserved = 0;
     // random
     std::mt19937 engine{std::random_device{}()};
     std::uniform_int_distribution<int> uniform{1, 100};
     
 public:
 
-    std::vector<std::vector<int>> clauses;
-    unsigned varCount = 0;
-
     ParallelPreprocess() {
         pre = new preprocess();
         preprocess_completed.store(false);
+        terminated.store(false);
+        preprocess_effort& effort = pre->effort;
+        effort.circuit = OPT(pp_circuit);
+        effort.gauss = OPT(pp_gauss);
+        effort.card = OPT(pp_card);
+        effort.card_size = OPT(pp_card_size);
+        effort.resolution = OPT(pp_elim);
+        effort.elim_occs = OPT(pp_elim_occs);
+        effort.elim_length = OPT(pp_elim_length);
+        effort.threads = OPT(pp_threads);
+        effort.binary = OPT(pp_binary);
+        effort.seconds = OPT(cutoff) * OPT(pp_time) / 100;
     }
     ~ParallelPreprocess() {
         delete pre;
@@ -39,12 +59,93 @@ public:
         return pre;
     }
 
+    // 预处理之后的公式，求解器和SBVA只通过这个只读视图读入
+    const Formula& formula() const {
+        return simplified;
+    }
+
+    // SBVA化简成功后的公式
+    const Formula& sbva_formula() const {
+        return sbva_simplified;
+    }
+
+    // 读入公式，整个流程只解析一次，同时输出解析耗时和峰值内存
+    void load_formula(const char* filename) {
+        if (loaded) return;
+        auto start = std::chrono::steady_clock::now();
+        pre->read_file(filename);
+        loaded = true;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        printf("c loaded %d vars, %d clauses in %.2f seconds, peak RSS %.1f MB\n",
+               pre->vars, pre->clauses, seconds, usage.ru_maxrss / 1024.0);
+    }
+
+    // 预处理结束后把子句转成CSR公式，并释放预处理器中的子句数组
+    void build_formula() {
+        simplified.build(pre->clause, pre->clauses, pre->vars);
+        printf("c formula: %d vars, %d clauses, %zu literals\n",
+               simplified.vars, simplified.size(), simplified.literals());
+    }
+
     std::vector<std::unique_ptr<YalsatSolver>>& get_yalsat_solvers() {
         return yalsat_solvers;
     }
+
+    void reserve_threads(int threads) {
+        reserved = threads;
+    }
+
+    // 变量消去的线程只用其他线程(局部搜索和流水线求解器)没有占用的核，至少一个
+    void limit_threads(int busy) {
+        int idle = (int)std::thread::hardware_concurrency() - busy;
+        pre->effort.threads = std::max(1, std::min(OPT(pp_threads), idle));
+    }
+
+    // 可以从其他线程调用。化简过程在下一次检查预算时结束，随后局部搜索也被终止，
+    // perform_preprocess返回0且不写缓存，不完整的结果不能再使用
+    void terminate() {
+        terminated.store(true);
+        pre->interrupted.store(true);
+    }
+
+    // 在缓存目录中查找同一输入的预处理结果，命中时跳过读入和预处理。
+    // 每个输入只查找一次，之前未命中时直接返回false
+    bool load_cache(const char* filename, int& result) {
+        if (OPT(cache).empty() || cache) return false;
+        auto start = std::chrono::steady_clock::now();
+        cache = std::make_unique<PreprocessCache>(OPT(cache), filename, pre->effort);
+        if (!cache->enabled()) return false;
+        if (!cache->load(pre, simplified, result)) {
+            printf("c no cached preprocessing result %s\n", cache->file().c_str());
+            return false;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printf("c loaded preprocessing result %d from cache %s in %.2f seconds\n",
+               result, cache->file().c_str(), seconds);
+        if (result == 0)
+            printf("c formula: %d vars, %d clauses, %zu literals\n",
+                   simplified.vars, simplified.size(), simplified.literals());
+        return true;
+    }
+
+    void store_cache(int result) {
+        if (!cache || !cache->enabled()) return;
+        // 被时间上限截断的化简结果不能给预算更多的运行复用；得出结论的结果与时间无关
+        if (result == 0 && pre->timed_out) {
+            printf("c preprocessing stopped at its time limit, result not cached\n");
+            return;
+        }
+        if (cache->store(pre, simplified, result))
+            printf("c stored preprocessing result in cache %s\n", cache->file().c_str());
+    }
     
     int perform_preprocess(const char* filename) {
-        pre->read_file(filename);
+        int result;
+        if (load_cache(filename, result)) return result;
+
+        load_formula(filename);
         if(OPT(yalsat) && pre->clauses > 33554431) {
             printf("c yalsat cannot handle more than 33554431 clauses\n");
             OPT(yalsat) = 0;
@@ -52,23 +153,19 @@ public:
 
         if(OPT(yalsat) && OPT(mode) == 0) {
             printf("c start local search init phase\n");
-            return do_parallel_preprocess(filename);
+            result = do_parallel_preprocess(filename);
         } else {
             printf("c start serial preprocess\n");
-            return do_serial_preprocess(filename);
+            result = do_serial_preprocess(filename);
         }
+
+        if (terminated) return 0;
+        store_cache(result);
+        return result;
     }
 
     int do_sbva_preprocess(int timeout, int num_sbva_threads) {
-        if(pre->clauses < 1e8) {
-            //copy clauses
-            for(int i=1; i<pre->clause.size(); i++) {
-                clauses.push_back(std::vector<int>());
-                for(int j=0; j<pre->clause[i].size(); j++) {
-                    clauses.back().push_back(pre->clause[i][j]);
-                }
-            }
-
+        if(simplified.size() < 1e8) {
             // 创建和运行SBVA线程
             std::vector<std::shared_ptr<StructuredBVA>> sbva_instances;
             std::vector<std::thread> sbva_threads;
@@ -85,7 +182,7 @@ public:
             for(int i=0; i<num_sbva_threads; i++) {
                 sbva_threads.push_back(std::thread([this, i, &sbva_instances, num_sbva_threads]() {
                     auto sbva = sbva_instances[i];
-                    sbva->addInitialClauses(clauses, pre->vars);
+                    sbva->addInitialClauses(simplified, pre->vars);
                     sbva->run();
                     sbva->printStatistics();
                     if(sbva->isInitialized() && sbva->getClausesCount() > 0) {
@@ -149,25 +246,25 @@ public:
                                pre->vars, best_sbva->getVariablesCount(), 
                                pre->clauses, best_sbva->getClausesCount(),
                                best_sbva->getNbClausesDeleted());
-                        clauses = std::move(best_sbva->getClauses());
-                        varCount = best_sbva->getVariablesCount();
+                        std::vector<std::vector<int>> result = best_sbva->getClauses();
+                        sbva_simplified.build(result, best_sbva->getVariablesCount());
                         return 1;
                     }
                 }
             }
             
             printf("c no effective sbva found\n");
-            varCount = pre->vars;
         } else {
             printf("c sbva not used\n");
-            varCount = pre->vars;
         }
         return 0;
     }
 
     int do_serial_preprocess(const char* filename) {
-        pre->read_file(filename);
+        load_formula(filename);
+        limit_threads(reserved);
         int preprocess_result = pre->do_preprocess();
+        if (preprocess_result == 0 && !terminated) build_formula();
         // if(preprocess_result == 0) {
         //     // copy clauses
         //     for (int i = 1; i < pre->clause.size(); i++) {
@@ -200,7 +297,7 @@ public:
 
     int do_parallel_preprocess(const char* filename) {        
         // 设置线程数目
-        int num_threads = OPT(threads);
+        int num_threads = OPT(threads) - reserved;
         if (num_threads <= 1) {
             num_threads = 2; // 至少使用两个线程
         }
@@ -211,21 +308,29 @@ public:
             yalsat_solvers.push_back(std::move(solver));
         }
 
-        // parallel read cnf for yalsat
-        std::vector<std::thread> yalsat_read_threads;
-        for (int i = 0; i < num_threads - 1; i++) {
-            yalsat_read_threads.push_back(std::thread([this, i]() {
-                yalsat_solvers[i]->read_from_proprocess(pre);
-            }));
-        }
+        if (OPT(clone)) {
+            // 只读入一次公式，其余实例从第一个实例克隆并共享子句和出现表
+            yalsat_solvers[0]->read_from_proprocess(pre);
+            for (int i = 1; i < num_threads - 1; i++)
+                yalsat_solvers[i]->read_from_solver(*yalsat_solvers[0]);
+        } else {
+            // parallel read cnf for yalsat
+            std::vector<std::thread> yalsat_read_threads;
+            for (int i = 0; i < num_threads - 1; i++) {
+                yalsat_read_threads.push_back(std::thread([this, i]() {
+                    yalsat_solvers[i]->read_from_proprocess(pre);
+                }));
+            }
 
-        for (auto& t : yalsat_read_threads) {
-            if (t.joinable()) {
-                t.join();
+            for (auto& t : yalsat_read_threads) {
+                if (t.joinable()) {
+                    t.join();
+                }
             }
         }
         
         preprocess_completed.store(false);
+        limit_threads(num_threads - 1 + reserved);
         
         // 预处理结果
         int preprocess_result = 0;
@@ -238,7 +343,7 @@ public:
             preprocess_completed.store(true);
         });
         
-        // 启动OPT(threads)-1个线程运行yalsat，使用不同的参数
+        // 启动num_threads-1个线程运行yalsat，使用不同的参数
         std::vector<std::thread> yalsat_threads;
         for (int i = 0; i < num_threads - 1; i++) {
             yalsat_threads.push_back(std::thread([this, i]() {
@@ -269,6 +374,8 @@ public:
             solver->checkAndUpdateBestPhase();
         }
         
+        if (preprocess_result == 0 && !terminated) build_formula();
+
         // 返回预处理的结果
         return preprocess_result;
     }
@@ -3,7 +3,7 @@
 #include "parellel_pre.hpp"
 
 // 构造函数
-PRS::PRS() {
+PRS::PRS() : start_time(std::chrono::steady_clock::now()) {
     
 }
 
@@ -91,51 +91,56 @@ void PRS::configure_solvers() {
             num_solvers, num_sat_group, num_unsat_group, num_default_group);
 }
 
-// 导出回调函数
-void PRS::export_callback(const int id, std::vector<std::shared_ptr<Clause>>& clauses) {
-    // 获取当前时间
-    auto current_time = std::chrono::steady_clock::now();
-    
-    // 检查是否达到分享时间间隔
-    if (last_share_times[id].time_since_epoch().count() == 0 || 
-        std::chrono::duration_cast<std::chrono::milliseconds>(
-            current_time - last_share_times[id]).count() >= OPT(share_intv)) {
-        
-        // 更新最后分享时间
-        last_share_times[id] = current_time;
-
-        // 共享子句并根据填充率调整导出限制
-        
-        Bucket& bucket = buckets[id];
-
-        // 将子句添加到桶中
-        while (!clauses.empty()) {
-            auto clause = clauses.back();
-            clauses.pop_back();
-            bucket.addClause(clause);
-        }
+// 获取求解结果模型
+vec<int>& PRS::getModel() {
+    return model;
+} 
+std::shared_future<std::shared_ptr<KissatSolver>> PRS::load_template(const Formula& formula, int count) {
+    if (!OPT(clone) || count < 2) return {};
+    return std::async(std::launch::async, [&formula]() {
+        auto start = std::chrono::steady_clock::now();
+        auto loaded = std::make_shared<KissatSolver>(-1);
+        loaded->configure("quiet", 1);
+        loaded->configure("check", 0);
+        loaded->read_from_formula(formula);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        printf("c loaded template kissat in %.2fs\n", elapsed.count());
+        return loaded;
+    }).share();
+}
 
-        // 收集要分享的子句
-        std::vector<std::shared_ptr<Clause>> share_buffer = bucket.collectSharingClauses();
+void PRS::load_solver(int i, const Formula& formula, std::shared_future<std::shared_ptr<KissatSolver>> loaded) {
+    // 等待模板时不占用加载名额
+    if (loaded.valid()) loaded.wait();
+    timed_load("kissat", i, [&]() {
+        if (loaded.valid()) solvers[i]->read_from_solver(*loaded.get());
+        else solvers[i]->read_from_formula(formula);
+    });
+}
 
-        // 向其他求解器分享子句
-        for (int i = 0; i < solvers.size(); i++) {
-            if (i != id) {
-                for (auto& clause : share_buffer) {
-                    solvers[i]->importClause(clause);
-                }
-            }
-        }
+void PRS::load_yalsat(int i, const Formula& formula) {
+    timed_load("yalsat", i, [&]() {
+        yalsat_solvers[i]->read_from_formula(formula);
+    });
+}
 
-        // 更新桶的填充率
-        int percent = bucket.getSharePercent();
-        // 负反馈调节
-        if (percent < 75) solvers[id]->broadenExportLimit();
-        if (percent > 98) solvers[id]->restrictExportLimit();
+void PRS::timed_load(const char* kind, int i, const std::function<void()>& load) {
+    using clock = std::chrono::steady_clock;
+    auto seconds = [](clock::duration d) { return std::chrono::duration<double>(d).count(); };
+    auto queued = clock::now();
+    {
+        std::unique_lock<std::mutex> lock(load_mutex);
+        load_cv.wait(lock, [this]() { return !OPT(loaders) || loading < OPT(loaders); });
+        loading++;
     }
+    auto begin = clock::now();
+    load();
+    {
+        std::lock_guard<std::mutex> lock(load_mutex);
+        loading--;
+    }
+    load_cv.notify_one();
+    auto end = clock::now();
+    printf("c %s %d waited %.2fs, loaded in %.2fs, solving at %.2fs\n",
+           kind, i, seconds(begin - queued), seconds(end - begin), seconds(end - start_time));
 }
-
-// 获取求解结果模型
-vec<int>& PRS::getModel() {
-    return model;
-} 
\ No newline at end of file
@@ -5,16 +5,20 @@
 #include <chrono>
 #include <atomic>
 #include <future>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 
 #include "solvers/kissat.hpp"
 #include "solvers/yalsat.hpp"
 #include "deversity.hpp"
 #include "options.hpp"
 #include "utils/vec.hpp"
-#include "prs/bucket.hpp"
+#include "prs/sharer.hpp"
 
 // 前向声明
 class preprocess;
+class ParallelPreprocess;
 
 // 并行SAT求解器类
 class PRS {
@@ -36,28 +40,47 @@ public:
     vec<int>& getModel();
 
 private:
-    // 子句共享处理函数
-    int shareClauses(std::vector<std::shared_ptr<Clause>>& clauses, int id);
-    
-    // 导出回调函数
-    void export_callback(const int id, std::vector<std::shared_ptr<Clause>>& clauses);
-    
+    // 在后台把公式加载到一个不参与求解的模板求解器中，供count个求解器拷贝。
+    // 未开启clone或只有一个求解器时返回无效的future
+    std::shared_future<std::shared_ptr<KissatSolver>> load_template(const Formula& formula, int count);
+
+    // 第i个求解器读取公式：模板有效时等待其加载完成后拷贝，否则直接读取
+    void load_solver(int i, const Formula& formula, std::shared_future<std::shared_ptr<KissatSolver>> loaded);
+
+    // 第i个yalsat求解器读取公式
+    void load_yalsat(int i, const Formula& formula);
+
+    // 执行一次加载并输出该求解器的启动时间线。同时加载的求解器不超过OPT(loaders)个，
+    // 避免所有线程同时拷贝子句库争抢内存带宽
+    void timed_load(const char* kind, int i, const std::function<void()>& load);
+
+    // 在[first, last)这些求解器中加载公式并各自在新线程中求解，future写入futures对应位置
+    void start_solvers(int first, int last, const Formula& formula, std::vector<std::future<int>>& futures);
+
+    // 预处理完成后在化简的公式上启动从first开始的求解器，设置最佳相位；
+    // first大于0时之前的求解器在原始公式上运行，这些求解器经变量映射参与分享
+    void start_simplified(ParallelPreprocess& pp, int first, std::vector<std::future<int>>& futures);
+
     // 求解器实例列表
     std::vector<KissatSolver*> solvers;
     std::vector<YalsatSolver*> yalsat_solvers;
     
-    // 每个线程对应的桶结构
-    std::vector<Bucket> buckets;
+    // 子句共享中心
+    std::unique_ptr<Sharer> sharer;
     
     // 结果模型
     vec<int> model;
-    
-    // 记录每个线程上次分享时间
-    std::vector<std::chrono::steady_clock::time_point> last_share_times;
 
 
+    // 程序启动时间，启动时间线以此为起点
+    std::chrono::steady_clock::time_point start_time;
+
+    // 正在加载公式的求解器数
+    std::mutex load_mutex;
+    std::condition_variable load_cv;
+    int loading = 0;
+
     // thread_local
-    std::vector<std::future<int>> read_futures;
     std::vector<std::future<int>> kissat_futures;
     std::vector<std::future<int>> yalsat_futures;
     std::future<int> sbva_future;
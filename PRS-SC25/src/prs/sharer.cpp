@@ -0,0 +1,181 @@
+#include "sharer.hpp"
+#include "options.hpp"
+
+#include <chrono>
+
+Sharer::Sharer(const std::vector<KissatSolver*>& solvers, int vars) :
+    solvers(solvers), pool(solvers.size()), topology(solvers), units(vars), equivalences(vars), usefulness(solvers.size()) {
+    buckets.resize(solvers.size());
+    delivered.resize(solvers.size());
+    for (auto solver : solvers) {
+        solver->setClausePool(&pool);
+        // 超过share_lits的子句不可能放进桶里，在求解器内就丢弃
+        solver->setExportSizeLimit(OPT(share_lits));
+        if (OPT(share_unit)) solver->setUnitStore(&units);
+        if (OPT(share_equiv)) solver->setEquivalenceStore(&equivalences);
+        if (OPT(share_mask)) solver->enableInactiveMask(vars);
+        if (OPT(share_use)) solver->enableUsefulness(solvers.size());
+        if (OPT(share_topo) == Topology::DIVERSITY) solver->enableStatistics(vars, 10000);
+    }
+    topology.print_groups();
+}
+
+Sharer::~Sharer() {
+    stop();
+}
+
+void Sharer::attachSimplified(int first, std::unique_ptr<VariableMap> variables) {
+    map = std::move(variables);
+    int vars = map->simplified_vars();
+    if (OPT(share_unit)) simplified_units = std::make_unique<UnitStore>(vars);
+    if (OPT(share_equiv)) simplified_equivalences = std::make_unique<EquivalenceStore>(vars);
+    for (int i = first; i < solvers.size(); i++) {
+        solvers[i]->setVariableMap(map.get());
+        if (OPT(share_unit)) solvers[i]->setUnitStore(simplified_units.get());
+        if (OPT(share_equiv)) solvers[i]->setEquivalenceStore(simplified_equivalences.get());
+    }
+    attached.store(true, std::memory_order_release);
+}
+
+void Sharer::start() {
+    hub = std::thread([this]() { run(); });
+}
+
+void Sharer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopped = true;
+    }
+    cv.notify_all();
+    if (hub.joinable()) hub.join();
+}
+
+void Sharer::printStatistics() {
+    printf("c sharing: exported %lld clauses, %lld duplicates suppressed (%.2f%%)\n",
+           nb_exported, nb_duplicates, nb_exported ? 100.0 * nb_duplicates / nb_exported : 0.0);
+    if (OPT(share_use)) printf("c sharing: %.2f%% of imported long clauses used in conflicts\n", 100 * usefulness.overall_rate());
+    if (OPT(share_mask)) printf("c sharing: %lld deliveries skipped by inactive variables\n", nb_masked);
+    if (OPT(share_unit)) printf("c sharing: %u global units\n", units.epoch());
+    if (OPT(share_equiv)) printf("c sharing: %u global equivalences\n", equivalences.epoch());
+    if (attached.load(std::memory_order_acquire))
+        printf("c sharing: %lld units and equivalences translated between variable spaces\n", nb_translated);
+}
+
+void Sharer::run() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!stopped) {
+        // 每隔share_intv毫秒进行一轮分享，stop时立即唤醒
+        cv.wait_for(lock, std::chrono::milliseconds(OPT(share_intv)), [this]() { return stopped; });
+        if (stopped) break;
+
+        lock.unlock();
+        // 定期重新分组
+        if (++rounds % OPT(share_rgrp) == 0) topology.regroup();
+        if (OPT(share_use)) usefulness.update(solvers);
+        if (attached.load(std::memory_order_acquire)) translate();
+        for (int i = 0; i < solvers.size(); i++) {
+            share(i);
+        }
+        lock.lock();
+    }
+}
+
+void Sharer::translate() {
+    // 原始空间中被固定或消元的变量在预处理后不存在，其单元和等价关系直接跳过；
+    // 反方向总能翻译到代表变量。已知的单元和等价关系不会被重复追加，转发不会循环
+    if (simplified_units) {
+        for (int lit; units_forwarded < units.epoch() && (lit = units.get(units_forwarded)); units_forwarded++)
+            if ((lit = map->forward(lit)) && simplified_units->add(lit)) nb_translated++;
+        for (int lit; units_backwarded < simplified_units->epoch() &&
+                      (lit = simplified_units->get(units_backwarded)); units_backwarded++)
+            if (units.add(map->backward(lit))) nb_translated++;
+    }
+    if (simplified_equivalences) {
+        int lit, other;
+        for (; equivalences_forwarded < equivalences.epoch() &&
+               equivalences.get(equivalences_forwarded, lit, other); equivalences_forwarded++)
+            if ((lit = map->forward(lit)) && (other = map->forward(other)) &&
+                simplified_equivalences->add(lit, other)) nb_translated++;
+        for (; equivalences_backwarded < simplified_equivalences->epoch() &&
+               simplified_equivalences->get(equivalences_backwarded, lit, other); equivalences_backwarded++)
+            if (equivalences.add(map->backward(lit), map->backward(other))) nb_translated++;
+    }
+}
+
+void Sharer::share(int id) {
+    Bucket& bucket = buckets[id];
+
+    // 将导出队列中的子句添加到桶中
+    solvers[id]->exportClauses(exported);
+    for (int i = 0; i < exported.size(); i += exported[i + 1] + 2) {
+        int lbd = exported[i], size = exported[i + 1];
+        const int* lits = &exported[i + 2];
+        nb_exported++;
+        if (!OPT(share_dup)) {
+            bucket.addClause(lbd, size, lits);
+            continue;
+        }
+        // 已经发给所有求解器的子句（包括其排列）不再进入桶
+        if (filter.contains(ClauseFilter::hash(lits, size))) {
+            nb_duplicates++;
+            continue;
+        }
+        bucket.addClause(lbd, size, lits);
+    }
+
+    // 收集要分享的子句写入共享池，消费者各自按游标读取。
+    // 子句发给同组的求解器，最短的一部分子句在跨组预算内同时发给其他组。
+    // 子句更有用的生产者得到更多预算，每个消费者按与该生产者的有用率限制导入配额
+    int budget = OPT(share_lits);
+    if (OPT(share_use)) budget = budget * usefulness.producer_weight(id);
+    const unsigned* group_targets = topology.group_targets(id).data();
+    const unsigned* all_targets = topology.all_targets(id).data();
+    int cross_space = budget * OPT(share_xgrp) / 100;
+    bool filtering = OPT(share_mask) || OPT(share_use);
+    std::fill(delivered.begin(), delivered.end(), 0);
+    bucket.collectSharingClauses(budget, [&](int lbd, int size, const int* lits) {
+        const unsigned* base = group_targets;
+        if (size <= cross_space) {
+            cross_space -= size;
+            base = all_targets;
+        }
+        // 只发给部分求解器的子句不记入过滤器，其他组的求解器之后导出同一子句时仍会分享。
+        // 因配额被跳过的消费者同样没有收到该子句
+        bool everyone = OPT(share_dup) && topology.reaches_all(id, base);
+        if (!filtering) {
+            pool.publish(id, lbd, size, lits, base);
+            if (everyone) filter.insert(ClauseFilter::hash(lits, size));
+            return;
+        }
+        // 跳过已经固定或消去子句中某个变量的消费者，这些子句到达后也只会被丢弃；
+        // 以及本轮已用完从该生产者导入配额的消费者
+        targets.assign(base, base + pool.target_words());
+        bool any = false;
+        for (int w = 0; w < targets.size(); w++) {
+            for (unsigned bits = targets[w]; bits; bits &= bits - 1) {
+                int consumer = w * 32 + __builtin_ctz(bits);
+                bool skip = false;
+                if (OPT(share_mask) && solvers[consumer]->hasInactive(lits, size)) {
+                    nb_masked++;
+                    skip = true;
+                } else if (OPT(share_use) &&
+                           delivered[consumer] + size > budget * usefulness.pair_weight(id, consumer)) {
+                    skip = true;
+                    everyone = false;
+                }
+                if (skip) targets[w] &= ~(1u << (consumer & 31));
+                else delivered[consumer] += size;
+            }
+            if (targets[w]) any = true;
+        }
+        if (any) pool.publish(id, lbd, size, lits, targets.data());
+        if (everyone) filter.insert(ClauseFilter::hash(lits, size));
+    });
+    pool.flush();
+
+    // 更新桶的填充率
+    int percent = bucket.getSharePercent();
+    // 负反馈调节
+    if (percent < 75) solvers[id]->broadenExportLimit();
+    if (percent > 98) solvers[id]->restrictExportLimit();
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+#include "solvers/kissat.hpp"
+#include "prs/bucket.hpp"
+#include "prs/clause_pool.hpp"
+#include "prs/clause_filter.hpp"
+#include "prs/topology.hpp"
+#include "prs/unit_store.hpp"
+#include "prs/equiv_store.hpp"
+#include "prs/usefulness.hpp"
+#include "prs/variable_map.hpp"
+
+// 子句共享中心：由独立的hub线程定期收集各求解器导出的子句并分发，
+// 求解器线程只需把学习子句压入自己的单生产者队列
+class Sharer {
+public:
+    Sharer(const std::vector<KissatSolver*>& solvers, int vars);
+    ~Sharer();
+
+    // 启动hub线程
+    void start();
+
+    // 停止hub线程并等待其退出
+    void stop();
+
+    // 输出分享统计信息
+    void printStatistics();
+
+    // 预处理完成后调用：从first开始的求解器读取预处理后的公式，它们的子句经map
+    // 翻译到原始变量空间分享，单元和等价文字则由hub线程在两个变量空间之间转发。
+    // 必须在这些求解器开始求解之前调用，此时hub线程可以已经在运行
+    void attachSimplified(int first, std::unique_ptr<VariableMap> map);
+
+    // 全局单元文字表，share_unit关闭时为nullptr
+    UnitStore* getUnitStore() {
+        return OPT(share_unit) ? &units : nullptr;
+    }
+
+private:
+    // hub线程主循环
+    void run();
+
+    // 处理一个生产者：收集、分享并根据填充率调整其导出限制
+    void share(int id);
+
+    // 在原始和预处理后的变量空间之间转发新的单元和等价文字
+    void translate();
+
+    std::vector<KissatSolver*> solvers;
+
+    // 每个生产者对应的桶结构
+    std::vector<Bucket> buckets;
+
+    // 所有求解器共享的子句池，只由hub线程写入
+    ClausePool pool;
+
+    // 分享拓扑
+    Topology topology;
+    int rounds = 0;
+
+    // 全局单元文字表，求解器直接读写，不经过hub线程
+    UnitStore units;
+
+    // 全局等价文字表，求解器直接读写，不经过hub线程
+    EquivalenceStore equivalences;
+
+    // 预处理后变量空间的单元和等价文字表，attachSimplified之后才有效。
+    // 游标为两个空间的日志中已经转发到另一侧的位置，只由hub线程访问
+    std::unique_ptr<VariableMap> map;
+    std::unique_ptr<UnitStore> simplified_units;
+    std::unique_ptr<EquivalenceStore> simplified_equivalences;
+    std::atomic<bool> attached{false};
+    unsigned units_forwarded = 0, units_backwarded = 0;
+    unsigned equivalences_forwarded = 0, equivalences_backwarded = 0;
+
+    // 已经发给所有求解器的子句，生产者再次导出时不进入桶
+    ClauseFilter filter;
+
+    // 从导出队列取出子句的暂存区
+    std::vector<int> exported;
+
+    // 按消费者失效变量和导入配额过滤后的接收者位图
+    std::vector<unsigned> targets;
+
+    // 导入子句有用性统计，以及本轮发给每个消费者的文字数
+    Usefulness usefulness;
+    std::vector<int> delivered;
+
+    // 统计信息
+    long long nb_exported = 0;
+    long long nb_duplicates = 0;
+    long long nb_masked = 0;
+    long long nb_translated = 0;
+
+    std::thread hub;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopped = false;
+};
@@ -4,6 +4,8 @@
 #include <vector>
 #include <cstdint>
 #include <cmath>
+#include <atomic>
+#include <cassert>
 
 class Statistics {
 private:
@@ -12,10 +14,10 @@ private:
     // 滑动窗口的大小
     int window_size;
     
-    // 记录每个变量的决策次数
-    std::vector<int> decide_counts;
+    // 记录每个变量的决策次数（求解器线程写入，分享线程读取）
+    std::vector<std::atomic<int>> decide_counts;
     // 记录每个变量的正相位次数
-    std::vector<int> positive_counts;
+    std::vector<std::atomic<int>> positive_counts;
     
     // 滑动窗口队列，存储历史决策文字
     std::queue<int> history_lits;
@@ -30,7 +32,11 @@ private:
         return lit > 0;
     }
 
-    bool initialized = false;
+    static inline void increment(std::atomic<int>& count, int delta) {
+        count.store(count.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    std::atomic<bool> initialized{false};
     
 public:
 
@@ -75,29 +81,31 @@ public:
 
     // 构造函数：接收变量的最大编号和滑动窗口大小
     Statistics(int max_var, int window_size) 
-        : max_var(max_var), window_size(window_size) {
-        // 初始化数组，索引从1开始，所以大小为max_var+1
-        decide_counts.resize(max_var + 1, 0);
-        positive_counts.resize(max_var + 1, 0);
+        : max_var(max_var), window_size(window_size),
+          // 初始化数组，索引从1开始，所以大小为max_var+1
+          decide_counts(max_var + 1), positive_counts(max_var + 1) {
         initialized = false;
     }
 
     static void static_on_decide_callback(void* state, int decide_lit) {
         Statistics* self = static_cast<Statistics*>(state);
         self->on_decide(decide_lit);
-        self->initialized = true;
+        if (!self->initialized.load(std::memory_order_relaxed))
+            self->initialized.store(true, std::memory_order_release);
     }
     
     // 回调函数：接收决策文字，更新统计信息
     void on_decide(int decide_lit) {
         int variable = var(decide_lit);
+        // SBVA引入的新变量不参与统计
+        if (variable > max_var) return;
         
-        // 更新决策计数
-        decide_counts[variable]++;
+        // 更新决策计数（单写者，无需原子加）
+        increment(decide_counts[variable], 1);
         
         // 更新相位计数
         if (is_positive(decide_lit)) {
-            positive_counts[variable]++;
+            increment(positive_counts[variable], 1);
         }
         
         // 将当前决策文字加入历史队列
@@ -109,16 +117,16 @@ public:
             history_lits.pop();
             
             int old_var = var(old_lit);
-            decide_counts[old_var]--;
+            increment(decide_counts[old_var], -1);
             
             if (is_positive(old_lit)) {
-                positive_counts[old_var]--;
+                increment(positive_counts[old_var], -1);
             }
         }
     }
 
     bool isInitialized() const {
-        return initialized;
+        return initialized.load(std::memory_order_acquire);
     }
     
     // 获取变量在当前窗口内的决策频次
@@ -126,21 +134,22 @@ public:
         if (variable <= 0 || variable > max_var) {
             return 0;
         }
-        return decide_counts[variable];
+        return decide_counts[variable].load(std::memory_order_relaxed);
     }
     
     // 获取变量在当前窗口内的正相位比例（0.0-1.0）
     double get_phase_average(int variable) const {
-        if (variable <= 0 || variable > max_var || decide_counts[variable] == 0) {
+        int decides = get_decide_frequency(variable);
+        if (decides == 0) {
             return 0.5; // 默认返回0.5表示中性
         }
-        return static_cast<double>(positive_counts[variable]) / decide_counts[variable];
+        return static_cast<double>(positive_counts[variable].load(std::memory_order_relaxed)) / decides;
     }
     
     // 清空所有统计信息
     void clear() {
-        std::fill(decide_counts.begin(), decide_counts.end(), 0);
-        std::fill(positive_counts.begin(), positive_counts.end(), 0);
+        for (auto& count : decide_counts) count.store(0, std::memory_order_relaxed);
+        for (auto& count : positive_counts) count.store(0, std::memory_order_relaxed);
         
         // 清空历史队列
         while (!history_lits.empty()) {
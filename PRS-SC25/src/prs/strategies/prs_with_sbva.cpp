@@ -18,17 +18,18 @@ int PRS::mix_solve(const char* filename) {
 
     printf("c read and proprocessing PRS...\n");
 
-    ParallelPreprocess pp;
-    int res = pp.do_serial_preprocess(filename);
+    // 求解结束时SBVA和后启动的求解器可能仍在读取化简后的公式，由它们共同持有pp
+    auto pp = std::make_shared<ParallelPreprocess>();
+    int res = pp->perform_preprocess(filename);
     if (res == 20) return 20; // UNSAT
     else if (res == 10) { // SAT
-        for (int i = 1; i <= pp.get_preprocess()->vars; i++) {
-            model.push(pp.get_preprocess()->model[i]);
+        for (int i = 1; i <= pp->get_preprocess()->vars; i++) {
+            model.push(pp->get_preprocess()->model[i]);
         }
         return 10;
     }
 
-    if (pp.get_preprocess()->clauses > 33554431) {
+    if (pp->get_preprocess()->clauses > 33554431) {
         printf("c too many clauses, yalsat not used\n");
         nbPrsYalsat = 0;
         nbSbvaYalsat = 0;
@@ -38,11 +39,6 @@ int PRS::mix_solve(const char* filename) {
 
     printf("c create solver instances ...\n");
 
-    // 初始化last_share_times
-    last_share_times.resize(OPT(threads));    
-    // 初始化桶排序
-    buckets.resize(OPT(threads));
-    
     // 清空原有求解器列表（如果有）
     for (auto solver : solvers) {
         if (solver) delete solver;
@@ -58,9 +54,6 @@ int PRS::mix_solve(const char* filename) {
     printf("c creating %d Kissat solver instances (%d PRS + %d SBVA) ...\n", nbKissat, nbPrsKissat, nbSbvaKissat);
     for (int i = 0; i < nbKissat; i++) {
         solvers.push_back(new KissatSolver(i));
-        solvers[i]->setExportCallback([this](int id, std::vector<std::shared_ptr<Clause>>& clauses) {
-            this->export_callback(id, clauses);
-        });
     }
 
     // 创建并初始化Yalsat求解器实例
@@ -73,46 +66,29 @@ int PRS::mix_solve(const char* filename) {
     printf("c configuring all solvers...\n");
     configure_solvers();
 
-    printf("c prs kissat read instance ...\n");
-
-    // Kissat求解器读取预处理后的实例
-    for (int i = 0; i < nbPrsKissat; i++) {
-        read_futures.push_back(std::async(std::launch::async, [this, i, &pp]() {
-            solvers[i]->read_from_proprocess(pp.get_preprocess());
-            return 0;
-        }));
-    }
-    // 等待所有PRS-Kissat读取完成
-    for (int i = 0; i < nbPrsKissat; i++) {
-        read_futures[i].wait();
-    }
-    read_futures.clear();
-    
-    // Yalsat求解器读取预处理后的实例
-    printf("c prs yalsat read instance ...\n");
-    for (int i = 0; i < nbPrsYalsat; i++) {
-        read_futures.push_back(std::async(std::launch::async, [this, i, &pp]() {
-            yalsat_solvers[i]->read_from_proprocess(pp.get_preprocess());
-            return 0;
-        }));
+    // 启动子句共享线程，之后每个求解器加载完公式立即开始求解，不等待其他求解器
+    sharer = std::make_unique<Sharer>(solvers, pp->get_preprocess()->vars);
+    if (sharer->getUnitStore()) {
+        for (auto solver : yalsat_solvers) solver->setUnitStore(sharer->getUnitStore());
     }
-    // 等待所有PRS-Yalsat读取完成
-    for (int i = 0; i < nbPrsYalsat; i++) {
-        read_futures[i].wait();
-    }
-    read_futures.clear();
+    sharer->start();
 
     printf("c start prs-yalsat(%d) and prs-kissat(%d) solving ...\n", nbPrsYalsat, nbPrsKissat);
 
-    
-
-    for (int i=0; i<nbPrsKissat; i++) {
-        kissat_futures.push_back(std::async(std::launch::async, [this, i]() {
+    // Kissat求解器读取预处理后的实例，公式只加载一次，其余求解器从模板拷贝
+    auto loaded = load_template(pp->formula(), nbPrsKissat);
+    for (int i = 0; i < nbPrsKissat; i++) {
+        kissat_futures.push_back(std::async(std::launch::async, [this, i, pp, loaded]() mutable {
+            load_solver(i, pp->formula(), std::move(loaded));
             return solvers[i]->solve();
         }));
-    }    
-    for (int i=0; i<nbPrsYalsat; i++) {
-        yalsat_futures.push_back(std::async(std::launch::async, [this, i]() {
+    }
+    loaded = {};
+
+    // Yalsat求解器读取预处理后的实例
+    for (int i = 0; i < nbPrsYalsat; i++) {
+        yalsat_futures.push_back(std::async(std::launch::async, [this, i, pp]() {
+            load_yalsat(i, pp->formula());
             return yalsat_solvers[i]->solve();
         }));
     }
@@ -124,8 +100,8 @@ int PRS::mix_solve(const char* filename) {
     // 已经在前面调用过configure_solvers，这里无需再次调用
     // configure_solvers();
 
-    sbva_future = std::async(std::launch::async, [this, &pp, nbSbvaKissat, nbSbvaYalsat]() {
-        return pp.do_sbva_preprocess(sbva_timeout, nbSbvaKissat + nbSbvaYalsat); // 原函数不接受超时参数
+    sbva_future = std::async(std::launch::async, [this, pp, nbSbvaKissat, nbSbvaYalsat]() {
+        return pp->do_sbva_preprocess(sbva_timeout, nbSbvaKissat + nbSbvaYalsat); // 原函数不接受超时参数
     });
 
     // 设置SBVA超时
@@ -135,7 +111,8 @@ int PRS::mix_solve(const char* filename) {
     bool any_success = false;
     res = 0;
     bool sbva_completed = false;
-    preprocess* pre = pp.get_preprocess();
+    preprocess* pre = pp->get_preprocess();
+    const Formula& formula = pp->formula();
 
     // 主循环，处理求解结果和SBVA化简完成后启动新求解器
     while(!any_success) {
@@ -203,27 +180,29 @@ int PRS::mix_solve(const char* filename) {
                 // 如果 SBVA 没启动
                 if (sbva_res == 0) {
                     // 启动SBVA-Kissat求解器
+                    auto loaded = load_template(formula, nbSbvaKissat);
                     for (int i = nbPrsKissat; i < nbPrsKissat + nbSbvaKissat; i++) {
                         printf("c (sbva failed) starting normal-Kissat solver %d\n", i);
-                        kissat_futures.push_back(std::async(std::launch::async, [this, i, pre]() {
-                            solvers[i]->read_from_proprocess(pre);
+                        kissat_futures.push_back(std::async(std::launch::async, [this, i, pp, loaded]() mutable {
+                            load_solver(i, pp->formula(), std::move(loaded));
                             return solvers[i]->solve();
                         }));
                     }
                     // 启动SBVA-Yalsat求解器
                     for (int i = nbPrsYalsat; i < nbPrsYalsat + nbSbvaYalsat; i++) {
                         printf("c (sbva failed) starting normal-Yalsat solver %d\n", i);
-                        yalsat_futures.push_back(std::async(std::launch::async, [this, i, pre]() {
-                            yalsat_solvers[i]->read_from_proprocess(pre);
+                        yalsat_futures.push_back(std::async(std::launch::async, [this, i, pp]() {
+                            load_yalsat(i, pp->formula());
                             return yalsat_solvers[i]->solve();
                         }));
                     }
                 } else {
                     // 启动SBVA-Kissat求解器
+                    auto loaded = load_template(pp->sbva_formula(), nbSbvaKissat);
                     for (int i = nbPrsKissat; i < nbPrsKissat + nbSbvaKissat; i++) {
                         printf("c starting SBVA-Kissat solver %d\n", i);
-                        kissat_futures.push_back(std::async(std::launch::async, [this, i, &pp]() {
-                            solvers[i]->read_from_vector(pp.clauses, pp.varCount);
+                        kissat_futures.push_back(std::async(std::launch::async, [this, i, pp, loaded]() mutable {
+                            load_solver(i, pp->sbva_formula(), std::move(loaded));
                             return solvers[i]->solve();
                         }));
                     }
@@ -231,8 +210,8 @@ int PRS::mix_solve(const char* filename) {
                     // 启动SBVA-Yalsat求解器
                     for (int i = nbPrsYalsat; i < nbPrsYalsat + nbSbvaYalsat; i++) {
                         printf("c starting SBVA-Yalsat solver %d\n", i);
-                        yalsat_futures.push_back(std::async(std::launch::async, [this, i, &pp]() {
-                            yalsat_solvers[i]->read_from_vector(pp.clauses, pp.varCount);
+                        yalsat_futures.push_back(std::async(std::launch::async, [this, i, pp]() {
+                            load_yalsat(i, pp->sbva_formula());
                             return yalsat_solvers[i]->solve();
                         }));
                     }
@@ -340,6 +319,9 @@ int PRS::mix_solve(const char* filename) {
         }
     }
 
+    sharer->stop();
+    sharer->printStatistics();
+
     // printf("kill done\n");
 
     // 处理SAT结果，映射到原始变量
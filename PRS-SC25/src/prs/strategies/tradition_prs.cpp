@@ -9,66 +9,63 @@ int PRS::solve(const char* filename) {
     
     printf("c solving...\n");
 
-    ParallelPreprocess pp;
-    res = pp.perform_preprocess(filename);
+    // 流水线模式下预处理在后台线程中运行。原始公式上的求解器先得到结果时终止预处理，
+    // 返回之前等待预处理线程结束
+    auto pp = std::make_unique<ParallelPreprocess>();
+    preprocess* pre = pp->get_preprocess();
+    Formula original;
+    std::future<int> preprocessed;
+    std::thread preprocessing;
+    int raw = 0;
 
-    printf("c preprocessing done\n");
+    if (pp->load_cache(filename, res)) {
+        printf("c preprocessing done\n");
+    } else if (OPT(pipeline) && OPT(threads) > 1) {
+        // 读入公式后前raw个求解器立即在原始公式上求解，其余线程照常做局部搜索和预处理
+        raw = std::min(OPT(pipeline), OPT(threads) - 1);
+        pp->load_formula(filename);
+        original.copy(pre->clause, pre->clauses, pre->vars);
+        pp->reserve_threads(raw);
+        std::promise<int> done;
+        preprocessed = done.get_future();
+        preprocessing = std::thread([&pp, filename, done = std::move(done)]() mutable {
+            done.set_value(pp->perform_preprocess(filename));
+        });
+        printf("c start %d kissat on the original formula while preprocessing\n", raw);
+    } else {
+        res = pp->perform_preprocess(filename);
+        printf("c preprocessing done\n");
+    }
     
     if (res == 20) return 20; // UNSAT
     else if (res == 10) { // SAT
-        for (int i = 1; i <= pp.get_preprocess()->vars; i++) {
-            model.push(pp.get_preprocess()->model[i]);
+        for (int i = 1; i <= pre->vars; i++) {
+            model.push(pre->model[i]);
         }
         return 10;
     }
 
-    // 初始化last_share_times
-    last_share_times.resize(OPT(threads));
-    
-    // 初始化桶排序
-    buckets.resize(OPT(threads));
-
     // 创建并初始化求解器实例
     for (int i = 0; i < OPT(threads); i++) {
         solvers.push_back(new KissatSolver(i));
-        solvers[i]->setExportCallback([this](const int id, std::vector<std::shared_ptr<Clause>>& clauses) {
-            this->export_callback(id, clauses);
-        });
-    }
-
-    if(OPT(yalsat)) {
-        solvers[0]->setBestPhase(nullptr);
-        for (int i=1; i<OPT(threads); i++) {
-            std::vector<int>& best_phase = pp.get_yalsat_solvers()[i-1]->best_phase;
-            if(best_phase.size() == pp.get_preprocess()->orivars + 1) {
-                solvers[i]->setBestPhase(best_phase.data());
-                printf("c set best phase for solver %d, min_unsat: %d\n", i, pp.get_yalsat_solvers()[i-1]->min_unsat);
-            } else {
-                solvers[i]->setBestPhase(nullptr);
-                printf("c no best phase for solver %d\n", i);
-            }
-        }
-    } else {
-        printf("c disable yalsat best phase because of too many clauses\n");
-        for (int i=0; i<OPT(threads); i++) {
-            solvers[i]->setBestPhase(nullptr);
-        }
     }
 
     // 配置求解器
     configure_solvers();
 
-    std::vector<std::future<int>> futures;
+    // 启动子句共享线程，流水线模式下在原始变量空间分享
+    sharer = std::make_unique<Sharer>(solvers, raw ? original.vars : pre->vars);
+    sharer->start();
 
-    preprocess* pre = pp.get_preprocess();
-    
-    // 并行启动所有求解器
-    for (int i = 0; i < OPT(threads); i++) {
-        futures.push_back(std::async(std::launch::async, [this, pre, i]() {
-            solvers[i]->read_from_proprocess(pre);
-            int result = solvers[i]->solve();
-            return result;
-        }));
+    std::vector<std::future<int>> futures(OPT(threads));
+
+    if (raw) {
+        for (int i = 0; i < raw; i++) {
+            solvers[i]->setBestPhase(nullptr);
+        }
+        start_solvers(0, raw, original, futures);
+    } else {
+        start_simplified(*pp, 0, futures);
     }
 
     int completed_thread = -1;
@@ -76,9 +73,19 @@ int PRS::solve(const char* filename) {
     
     // 轮询所有future，检查哪个线程先完成
     while (!any_success) {
+        // 预处理完成后在化简的公式上启动其余求解器，预处理直接得出结果时结束
+        if (preprocessed.valid() &&
+            preprocessed.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            res = preprocessed.get();
+            printf("c preprocessing done\n");
+            if (res != 0) break;
+            start_simplified(*pp, raw, futures);
+        }
         // 检查kissat线程
+        bool running = false;
         for (int i = 0; i < OPT(threads); i++) {
             if (futures[i].valid()) {
+                running = true;
                 auto status = futures[i].wait_for(std::chrono::milliseconds(100));
                 if (status == std::future_status::ready) {
                     res = futures[i].get();
@@ -90,6 +97,11 @@ int PRS::solve(const char* filename) {
                 }
             }
         }
+        // 没有正在运行的求解器时阻塞等待预处理，预处理也已结束时没有任何结果
+        if (!running && !any_success) {
+            if (!preprocessed.valid()) break;
+            preprocessed.wait();
+        }
     }
     
     // 终止其他求解器
@@ -99,32 +111,52 @@ int PRS::solve(const char* filename) {
         }
     }
     
+    // 求解器先得出结果时预处理不再需要
+    if (preprocessed.valid()) pp->terminate();
+
     // 等待所有线程结束
+    if (preprocessing.joinable()) preprocessing.join();
     for (int i = 0; i < futures.size(); i++) {
         if (i != completed_thread && futures[i].valid()) {
             futures[i].wait();
         }
     }
 
-    printf("c problem solved by thread %d\n",  completed_thread);
+    sharer->stop();
+    sharer->printStatistics();
+
+    if (completed_thread < 0) {
+        if (res) printf("c problem solved by preprocessing\n");
+    }
+    else printf("c problem solved by thread %d\n",  completed_thread);
 
     // 处理SAT结果
     if (res == 10) {
-        // 从成功求解器获取模型
         model.clear();
+        if (completed_thread < 0) {
+            for (int i = 1; i <= pre->vars; i++) {
+                model.push(pre->model[i]);
+            }
+        } else if (completed_thread < raw) {
+            // 原始公式上的求解器直接给出原始变量的取值
+            for (int i = 1; i <= original.vars; i++) {
+                model.push(solvers[completed_thread]->getValue(i));
+            }
+        } else {
             // 从kissat获取模型
-        for (int i = 1; i <= pre->vars; i++) {
-            model.push(solvers[completed_thread]->getValue(i));
-        }
-        
-        // 映射到原始变量
-        for (int i = 1; i <= pre->orivars; i++)
-            if (pre->mapto[i]) pre->mapval[i] = (model[abs(pre->mapto[i])-1] > 0 ? 1 : -1) * (pre->mapto[i] > 0 ? 1 : -1);
-        
-        pre->get_complete_model();
-        model.clear();
-        for (int i = 1; i <= pre->orivars; i++) {
-            model.push(i * pre->mapval[i]);
+            for (int i = 1; i <= pre->vars; i++) {
+                model.push(solvers[completed_thread]->getValue(i));
+            }
+            
+            // 映射到原始变量
+            for (int i = 1; i <= pre->orivars; i++)
+                if (pre->mapto[i]) pre->mapval[i] = (model[abs(pre->mapto[i])-1] > 0 ? 1 : -1) * (pre->mapto[i] > 0 ? 1 : -1);
+            
+            pre->get_complete_model();
+            model.clear();
+            for (int i = 1; i <= pre->orivars; i++) {
+                model.push(i * pre->mapval[i]);
+            }
         }
     }
 
@@ -134,4 +166,49 @@ int PRS::solve(const char* filename) {
     }
 
     return res;
-}
\ No newline at end of file
+}
+
+void PRS::start_simplified(ParallelPreprocess& pp, int first, std::vector<std::future<int>>& futures) {
+    preprocess* pre = pp.get_preprocess();
+    auto& yalsat_solvers = pp.get_yalsat_solvers();
+
+    // 从缓存读入预处理结果时没有运行局部搜索，也就没有最佳相位。
+    // 第一个求解器不使用最佳相位，之后的求解器依次使用各个yalsat的结果
+    if(OPT(yalsat) && !yalsat_solvers.empty()) {
+        solvers[first]->setBestPhase(nullptr);
+        for (int i = first + 1; i < OPT(threads); i++) {
+            int k = i - first - 1;
+            if (k < yalsat_solvers.size() && yalsat_solvers[k]->best_phase.size() == pre->orivars + 1) {
+                solvers[i]->setBestPhase(yalsat_solvers[k]->best_phase.data());
+                printf("c set best phase for solver %d, min_unsat: %d\n", i, yalsat_solvers[k]->min_unsat);
+            } else {
+                solvers[i]->setBestPhase(nullptr);
+                printf("c no best phase for solver %d\n", i);
+            }
+        }
+    } else {
+        printf("c disable yalsat best phase\n");
+        for (int i = first; i < OPT(threads); i++) {
+            solvers[i]->setBestPhase(nullptr);
+        }
+    }
+
+    // 已有求解器在原始公式上运行时，之后的求解器经变量映射参与分享
+    if (first > 0)
+        sharer->attachSimplified(first, std::make_unique<VariableMap>(pre->mapto, pre->mapval, pre->orivars, pre->vars));
+
+    start_solvers(first, OPT(threads), pp.formula(), futures);
+}
+
+void PRS::start_solvers(int first, int last, const Formula& formula, std::vector<std::future<int>>& futures) {
+    // 公式只加载一次，各求解器线程从模板拷贝后开始求解
+    auto loaded = load_template(formula, last - first);
+
+    for (int i = first; i < last; i++) {
+        futures[i] = std::async(std::launch::async, [this, &formula, loaded, i]() mutable {
+            load_solver(i, formula, std::move(loaded));
+            int result = solvers[i]->solve();
+            return result;
+        });
+    }
+}
@@ -0,0 +1,70 @@
+#include "topology.hpp"
+#include "options.hpp"
+
+#include <algorithm>
+
+Topology::Topology(const std::vector<KissatSolver*>& solvers) :
+    nb_solvers(solvers.size()), deversity(solvers) {
+    words = (nb_solvers + 31) / 32;
+    group_of.resize(nb_solvers);
+    group_mask.assign(nb_solvers, std::vector<unsigned>(words));
+    all_mask.assign(nb_solvers, std::vector<unsigned>(words));
+    group_full.assign(nb_solvers, 0);
+    all_full.assign(nb_solvers, 0);
+    regroup();
+}
+
+void Topology::regroup() {
+    groups.clear();
+    int topo = OPT(share_topo);
+    if (topo == ALL) {
+        groups.emplace_back();
+        for (int i = 0; i < nb_solvers; i++) groups.back().push_back(i);
+    } else if (topo == DIVERSITY) {
+        groups = deversity.generate_groups();
+    } else {
+        std::vector<int> order(nb_solvers);
+        for (int i = 0; i < nb_solvers; i++) order[i] = i;
+        std::shuffle(order.begin(), order.end(), rng);
+        for (int i = 0; i < nb_solvers; i++) {
+            if (i % OPT(share_grps) == 0) groups.emplace_back();
+            groups.back().push_back(order[i]);
+        }
+    }
+    for (int g = 0; g < groups.size(); g++) {
+        for (int i : groups[g]) group_of[i] = g;
+    }
+    build_masks();
+}
+
+void Topology::build_masks() {
+    auto set = [](std::vector<unsigned>& mask, int i) { mask[i / 32] |= 1u << (i & 31); };
+    int nb_groups = groups.size();
+    for (int i = 0; i < nb_solvers; i++) {
+        std::fill(group_mask[i].begin(), group_mask[i].end(), 0);
+        std::fill(all_mask[i].begin(), all_mask[i].end(), 0);
+        int g = group_of[i];
+        for (int j : groups[g]) {
+            if (j != i) set(group_mask[i], j), set(all_mask[i], j);
+        }
+        // 环形拓扑只向下一组分享，其余拓扑向所有其他组分享
+        for (int h = 0; h < nb_groups; h++) {
+            if (h == g) continue;
+            if (OPT(share_topo) == RING && h != (g + 1) % nb_groups) continue;
+            for (int j : groups[h]) set(all_mask[i], j);
+        }
+        int in_group = groups[g].size() - 1, in_all = 0;
+        for (unsigned w : all_mask[i]) in_all += __builtin_popcount(w);
+        group_full[i] = in_group == nb_solvers - 1;
+        all_full[i] = in_all == nb_solvers - 1;
+    }
+}
+
+void Topology::print_groups() {
+    printf("c share groups (topology %d): ", OPT(share_topo));
+    for (auto& group : groups) {
+        for (int i : group) printf("%d ", i);
+        printf("| ");
+    }
+    printf("\n");
+}
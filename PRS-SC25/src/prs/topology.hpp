@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <random>
+
+#include "solvers/kissat.hpp"
+#include "deversity.hpp"
+
+// 分享拓扑：把求解器划分为若干组，组内完全分享，跨组只分享少量最短的子句
+class Topology {
+public:
+    enum { ALL = 0, STATIC = 1, RING = 2, DIVERSITY = 3 };
+
+    Topology(const std::vector<KissatSolver*>& solvers);
+
+    // 重新分组：静态与环形拓扑随机打乱，多样性拓扑按决策统计重新聚类
+    void regroup();
+
+    // 组内接收者位图（不含自身）
+    const std::vector<unsigned>& group_targets(int id) const {
+        return group_mask[id];
+    }
+
+    // 组内加跨组的全部接收者位图
+    const std::vector<unsigned>& all_targets(int id) const {
+        return all_mask[id];
+    }
+
+    // 接收者位图是否包含除生产者之外的所有求解器
+    bool reaches_all(int id, const unsigned* targets) const {
+        return targets == all_mask[id].data() ? all_full[id] : group_full[id];
+    }
+
+    void print_groups();
+
+private:
+    void build_masks();
+
+    int nb_solvers;
+    int words;
+    std::vector<std::vector<int>> groups;
+    std::vector<int> group_of;
+    std::vector<std::vector<unsigned>> group_mask, all_mask;
+    std::vector<char> group_full, all_full;
+    std::mt19937 rng{std::random_device{}()};
+    Deversity deversity;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+
+// 全局单元文字表：所有求解器线程直接无锁写入，不经过分享线程和桶。
+// values按外部变量记录已知的单元，units是只追加的单元序列，
+// 已预留的单元数即epoch，求解器只需比较epoch就知道是否有新单元
+class UnitStore {
+public:
+    UnitStore(int vars) : values(vars + 1), units(vars + 2) {}
+
+    // 记录一个单元文字，返回是否为新单元。超出变量范围的文字直接忽略
+    bool add(int lit) {
+        int var = abs(lit);
+        if (var == 0 || var >= values.size()) return false;
+        signed char sign = lit > 0 ? 1 : -1;
+        signed char expected = 0;
+        if (!values[var].compare_exchange_strong(expected, sign, std::memory_order_acq_rel)) {
+            if (expected == sign) return false;
+            // 出现相反的单元说明公式不可满足，只发布第一个冲突让求解器推出空子句
+            if (conflicting.exchange(true, std::memory_order_acq_rel)) return false;
+        }
+        unsigned slot = reserved.fetch_add(1, std::memory_order_acq_rel);
+        units[slot].store(lit, std::memory_order_release);
+        return true;
+    }
+
+    // 已预留的单元数，单调递增
+    unsigned epoch() const {
+        return reserved.load(std::memory_order_acquire);
+    }
+
+    // 第index个单元，写入尚未完成时返回0
+    int get(unsigned index) const {
+        return units[index].load(std::memory_order_acquire);
+    }
+
+    // 变量的已知取值：1、-1，未知为0
+    int value(int var) const {
+        return values[var].load(std::memory_order_relaxed);
+    }
+
+    static void static_export_callback(void* state, int unit) {
+        static_cast<UnitStore*>(state)->add(unit);
+    }
+
+    static unsigned static_epoch_callback(void* state) {
+        return static_cast<UnitStore*>(state)->epoch();
+    }
+
+    static int static_import_callback(void* state, unsigned index) {
+        return static_cast<UnitStore*>(state)->get(index);
+    }
+
+private:
+    std::vector<std::atomic<signed char>> values;
+    std::vector<std::atomic<int>> units;
+    std::atomic<unsigned> reserved{0};
+    std::atomic<bool> conflicting{false};
+};
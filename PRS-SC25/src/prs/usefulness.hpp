@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+#include "solvers/kissat.hpp"
+
+// 共享子句有用性统计：每轮从各消费者读取按生产者分类的导入数和有用数，
+// 以指数衰减的累计值估计每个生产者、每对(生产者, 消费者)的有用率，
+// 用来调整生产者的分享预算和消费者的导入配额
+class Usefulness {
+public:
+    Usefulness(int solvers) : n(solvers),
+        last_imported(n * n), last_useful(n * n), imported(n * n), useful(n * n),
+        producer_rate(n, -1), pair_rate(n * n, -1) {}
+
+    // 读取所有消费者的计数并更新有用率
+    void update(const std::vector<KissatSolver*>& solvers) {
+        for (int c = 0; c < n; c++) {
+            const uint64_t* counts = solvers[c]->getUsefulness();
+            if (!counts) continue;
+            for (int p = 0; p < n; p++) {
+                uint64_t imp = __atomic_load_n(counts + p, __ATOMIC_RELAXED);
+                uint64_t use = __atomic_load_n(counts + n + p, __ATOMIC_RELAXED);
+                int k = p * n + c;
+                imported[k] = imported[k] * DECAY + (imp - last_imported[k]);
+                useful[k] = useful[k] * DECAY + (use - last_useful[k]);
+                last_imported[k] = imp, last_useful[k] = use;
+                pair_rate[k] = imported[k] >= MIN_IMPORTED ? useful[k] / imported[k] : -1;
+            }
+        }
+
+        double sum_rate = 0;
+        int rated = 0;
+        for (int p = 0; p < n; p++) {
+            double imp = 0, use = 0;
+            for (int c = 0; c < n; c++) imp += imported[p * n + c], use += useful[p * n + c];
+            producer_rate[p] = imp >= MIN_IMPORTED ? use / imp : -1;
+            if (producer_rate[p] >= 0) sum_rate += producer_rate[p], rated++;
+        }
+        mean_rate = rated ? sum_rate / rated : -1;
+    }
+
+    // 生产者分享预算的系数，有用率高于平均的生产者得到更多预算
+    double producer_weight(int p) const {
+        if (producer_rate[p] < 0 || mean_rate <= 0) return 1;
+        return std::min(2.0, std::max(0.25, producer_rate[p] / mean_rate));
+    }
+
+    // 消费者从该生产者导入的配额系数，相对于生产者整体有用率
+    double pair_weight(int p, int c) const {
+        double rate = pair_rate[p * n + c];
+        if (rate < 0 || producer_rate[p] <= 0) return 1;
+        return std::min(1.0, std::max(0.25, rate / producer_rate[p]));
+    }
+
+    // 整个求解过程中导入的长子句被用到的比例
+    double overall_rate() const {
+        double imp = 0, use = 0;
+        for (int k = 0; k < n * n; k++) imp += last_imported[k], use += last_useful[k];
+        return imp > 0 ? use / imp : 0;
+    }
+
+private:
+    static constexpr double DECAY = 0.9;
+    static constexpr double MIN_IMPORTED = 20;
+
+    int n;
+    std::vector<uint64_t> last_imported, last_useful;
+    std::vector<double> imported, useful;
+    std::vector<double> producer_rate, pair_rate;
+    double mean_rate = -1;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+
+// 预处理前后的变量对应关系。原始变量v对应预处理后的文字mapto[v]，
+// mapto[v]为0时变量已被固定(mapval为±1)或被消元(mapval为-10)；
+// 预处理后的每个变量反过来对应到映射到它的编号最小的原始变量。
+// 构造时拷贝一份，求解结束后预处理器修改mapval不影响翻译
+class VariableMap {
+public:
+    VariableMap(const int* mapto, const int* mapval, int orivars, int vars)
+        : to(mapto, mapto + orivars + 1), fixed(orivars + 1, 0), from(vars + 1, 0) {
+        for (int v = orivars; v >= 1; v--) {
+            if (to[v]) from[abs(to[v])] = to[v] > 0 ? v : -v;
+            else if (abs(mapval[v]) == 1) fixed[v] = mapval[v];
+        }
+    }
+
+    int original_vars() const { return to.size() - 1; }
+    int simplified_vars() const { return from.size() - 1; }
+
+    // 原始文字被固定后的取值：1为真，-1为假，未固定为0
+    int value(int lit) const {
+        int val = fixed[abs(lit)];
+        return lit < 0 ? -val : val;
+    }
+
+    // 原始文字在预处理后的文字，变量已被固定或消元时返回0
+    int forward(int lit) const {
+        int var = abs(lit);
+        if (var >= to.size()) return 0;
+        return lit < 0 ? -to[var] : to[var];
+    }
+
+    // 预处理后的文字在原始空间中的代表文字，没有对应变量时返回0
+    int backward(int lit) const {
+        int var = abs(lit);
+        if (var >= from.size()) return 0;
+        return lit < 0 ? -from[var] : from[var];
+    }
+
+    // 把原始子句翻译成预处理后的子句：删去被固定为假的文字和重复文字。
+    // 子句已被满足、含有消元变量或翻译后为重言式时返回false，丢弃该子句
+    bool forward_clause(const int* lits, int size, std::vector<int>& out) const {
+        out.clear();
+        for (int i = 0; i < size; i++) {
+            int val = value(lits[i]);
+            if (val > 0) return false;
+            if (val < 0) continue;
+            int lit = forward(lits[i]);
+            if (!lit) return false;
+            out.push_back(lit);
+        }
+        // 等价的原始变量映射到同一个变量
+        std::sort(out.begin(), out.end(), [](int a, int b) {
+            return abs(a) < abs(b) || (abs(a) == abs(b) && a < b);
+        });
+        int n = 0;
+        for (int i = 0; i < out.size(); i++) {
+            if (n && out[n - 1] == out[i]) continue;
+            if (n && out[n - 1] == -out[i]) return false;
+            out[n++] = out[i];
+        }
+        out.resize(n);
+        return n > 0;
+    }
+
+    // 把预处理后的子句原地翻译到原始空间，有变量没有对应时返回false
+    bool backward_clause(int* lits, int size) const {
+        for (int i = 0; i < size; i++) {
+            lits[i] = backward(lits[i]);
+            if (!lits[i]) return false;
+        }
+        return true;
+    }
+
+private:
+    std::vector<int> to;
+    std::vector<int> fixed;
+    std::vector<int> from;
+};
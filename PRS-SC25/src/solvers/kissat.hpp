@@ -5,13 +5,16 @@
 #include <string>
 #include <memory>
 #include <iostream>
-#include <boost/lockfree/spsc_queue.hpp>
-#include <functional>
+#include <limits>
+#include <atomic>
 
 #include "preprocess/preprocess.hpp"
-#include "prs/clause.hpp"
-#include "utils/concurrentqueue.h"
+#include "utils/formula.hpp"
+#include "prs/clause_pool.hpp"
+#include "prs/unit_store.hpp"
+#include "prs/equiv_store.hpp"
 #include "prs/statistics.hpp"
+#include "prs/variable_map.hpp"
 
 extern "C" {
     #include "kissat.h"
@@ -22,7 +25,7 @@ class KissatSolver {
 public:
     KissatSolver(int id) : id(id) {
         solver = kissat_init();
-        kissat_set_prs_export_clause_function(solver, static_export_callback, this);
+        kissat_enable_prs_export(solver, export_log_size);
         kissat_set_prs_import_clause_function(solver, static_import_callback, this);
     }
     ~KissatSolver() {
@@ -30,6 +33,7 @@ public:
             kissat_release(solver);
             solver = nullptr;
         }
+        delete statistics;
     }
 
     void configure(const char* name, int val) {
@@ -40,24 +44,14 @@ public:
         kissat_set_prs_best_phase(solver, best_phase);
     }
 
-    void read_from_proprocess(preprocess* pre) {
-        kissat_reserve(solver, pre->vars);
-        for (int i = 1; i <= pre->clauses; i++) {
-            int l = pre->clause[i].size();
-            for (int j = 0; j < l; j++)
-                kissat_add(solver, pre->clause[i][j]);
-            kissat_add(solver, 0);
-        }
+    void read_from_formula(const Formula& formula) {
+        kissat_reserve(solver, formula.vars);
+        kissat_add_clauses(solver, formula.size(), formula.offset_data(), formula.literal_data());
     }
 
-    void read_from_vector(std::vector<std::vector<int>>& clauses, int vars) {
-        kissat_reserve(solver, vars);
-        for (int i = 0; i < clauses.size(); i++) {
-            int l = clauses[i].size();
-            for (int j = 0; j < l; j++)
-                kissat_add(solver, clauses[i][j]);
-            kissat_add(solver, 0);
-        }
+    // 从已加载公式且尚未求解的求解器深拷贝子句库，本求解器的选项需事先配置好
+    void read_from_solver(const KissatSolver& loaded) {
+        kissat_clone(solver, loaded.solver);
     }
 
     void add(int lit) {
@@ -84,24 +78,111 @@ public:
         kissat_reserve(solver, vars);
     }
 
-    // 添加回调函数类型定义
-    using ExportCallback = std::function<void(const int id, std::vector<std::shared_ptr<Clause>>&)>;
-    
-    // 设置回调函数的方法
-    void setExportCallback(ExportCallback callback) {
-        export_callback = callback;
+    // 由分享线程调用，取出导出缓冲区中的全部子句，格式为[lbd, size, lits...]
+    void exportClauses(std::vector<int>& clauses) {
+        size_t n = kissat_prs_export_available(solver);
+        clauses.resize(n);
+        kissat_prs_export_clauses(solver, clauses.data(), n);
+        const VariableMap* map = mapping.load(std::memory_order_acquire);
+        if (!map) return;
+        // 翻译到原始变量空间，丢弃无法翻译的子句
+        size_t kept = 0;
+        for (size_t i = 0; i < clauses.size(); i += clauses[i + 1] + 2) {
+            int size = clauses[i + 1];
+            if (!map->backward_clause(&clauses[i + 2], size)) continue;
+            std::copy(clauses.begin() + i, clauses.begin() + i + size + 2, clauses.begin() + kept);
+            kept += size + 2;
+        }
+        clauses.resize(kept);
+    }
+
+    // 本求解器读取的是预处理后的公式时设置变量映射，分享的子句在原始变量空间，
+    // 导入和导出时经过翻译。必须在求解开始前调用
+    void setVariableMap(const VariableMap* map) {
+        mapping.store(map, std::memory_order_release);
+    }
+
+    // 设置导入子句的来源，必须在求解开始前调用
+    void setClausePool(ClausePool* pool) {
+        clause_pool = pool;
+    }
+
+    // 连接全局单元文字表，学到的单元直接写入并在根层和重启时导入，必须在求解开始前调用
+    void setUnitStore(UnitStore* units) {
+        kissat_set_prs_unit_functions(solver, UnitStore::static_export_callback,
+            UnitStore::static_epoch_callback, UnitStore::static_import_callback, units);
+    }
+
+    // 连接全局等价文字表，发现的等价关系直接写入，导入后在根层做等价替换，必须在求解开始前调用
+    void setEquivalenceStore(EquivalenceStore* equivalences) {
+        kissat_set_prs_equivalence_functions(solver, EquivalenceStore::static_export_callback,
+            EquivalenceStore::static_epoch_callback, EquivalenceStore::static_import_callback, equivalences);
     }
 
-    void importClause(std::shared_ptr<Clause> clause) {
-        import_clause_queue.enqueue(clause);
+    // 开启失效变量位图，分享线程据此跳过会在导入时被丢弃的子句，必须在求解开始前调用
+    void enableInactiveMask(int vars) {
+        kissat_enable_prs_inactive(solver, vars);
+        inactive = kissat_prs_inactive(solver);
+        inactive_vars = vars;
+    }
+
+    // 子句中是否有变量在本求解器中已被固定或消去
+    bool hasInactive(const int* lits, int size) const {
+        if (!inactive) return false;
+        const VariableMap* map = mapping.load(std::memory_order_acquire);
+        for (int i = 0; i < size; i++) {
+            int lit = lits[i];
+            if (map) {
+                // 已被满足或含消元变量的子句在导入时会被丢弃，被固定为假的文字会被删去
+                int val = map->value(lit);
+                if (val > 0) return true;
+                if (val < 0) continue;
+                if (!(lit = map->forward(lit))) return true;
+            }
+            int var = abs(lit);
+            if (var > inactive_vars) continue;
+            uint64_t word = __atomic_load_n(inactive + var / 64, __ATOMIC_RELAXED);
+            if (word >> (var & 63) & 1) return true;
+        }
+        return false;
+    }
+
+    // 开启导入子句有用性计数，必须在求解开始前调用
+    void enableUsefulness(int producers) {
+        kissat_enable_prs_usefulness(solver, producers);
+        usefulness = kissat_prs_usefulness(solver);
+    }
+
+    // 按生产者的导入数和有用数，未开启时为nullptr
+    const uint64_t* getUsefulness() const {
+        return usefulness;
+    }
+
+    // 开启决策统计，用于按多样性分组，必须在求解开始前调用
+    void enableStatistics(int vars, int window_size) {
+        if (statistics) return;
+        statistics = new Statistics(vars, window_size);
+        kissat_set_prs_decide_function(solver, Statistics::static_on_decide_callback, statistics);
+    }
+
+    Statistics* getStatistics() {
+        return statistics;
+    }
+
+    // 以下导出上限只由分享线程修改，求解器在复制文字之前按上限过滤
+    void setExportSizeLimit(int size) {
+        export_size = size;
+        kissat_set_prs_export_limit(solver, good_lbd, export_size);
     }
 
     void broadenExportLimit() {
         good_lbd++;
+        kissat_set_prs_export_limit(solver, good_lbd, export_size);
     }
 
     void restrictExportLimit() {
-        if(good_lbd > 2) good_lbd--;
+        if (good_lbd > 2) good_lbd--;
+        kissat_set_prs_export_limit(solver, good_lbd, export_size);
     }
 
 
@@ -115,59 +196,61 @@ public:
 
 private:
 
-    static void static_export_callback(void* state, cvec* clause, int lbd) {
+    static int static_import_callback(void* state, cvec* clause, int *lbd, int *producer) {
         KissatSolver* self = static_cast<KissatSolver*>(state);
-        self->my_export_callback(clause, lbd);
+        return self->my_import_callback(clause, lbd, producer);
     }
 
-    void my_export_callback(cvec* clause, int lbd) {
-        assert(clause->sz > 0);
-        
-        if(lbd > good_lbd) return;
-
-        std::shared_ptr<Clause> clause_ptr = std::make_shared<Clause>(lbd, clause->sz);
-        for (size_t i = 0; i < clause->sz; ++i) {
-            clause_ptr->literals[i] = clause->data[i];
-        }
-        
-        learned_clause.push_back(clause_ptr);
-
-        assert(export_callback);
-        export_callback(id, learned_clause);
-    }
-
-    static int static_import_callback(void* state, cvec* clause, int *lbd) {
-        KissatSolver* self = static_cast<KissatSolver*>(state);
-        return self->my_import_callback(clause, lbd);
-    }
-
-    int my_import_callback(cvec* clause, int *lbd) {
+    int my_import_callback(cvec* clause, int *lbd, int *producer) {
         assert(clause->sz == 0);
         // printf("thread %d import clause\n", id);
-        std::shared_ptr<Clause> clause_ptr;
-        if(!import_clause_queue.try_dequeue(clause_ptr)) {
-            return -1;
+        if (!clause_pool) return -1;
+        const VariableMap* map = mapping.load(std::memory_order_relaxed);
+        const int* rec;
+        int size;
+        const int* lits;
+        while (true) {
+            rec = clause_pool->next(id);
+            if (!rec) return -1;
+            size = rec[2];
+            lits = clause_pool->literals(rec);
+            if (!map) break;
+            // 池中的子句在原始变量空间，翻译到本求解器的变量
+            if (!map->forward_clause(lits, size, translated)) continue;
+            size = translated.size();
+            lits = translated.data();
+            break;
         }
-        // 将clause_ptr中的数据复制到clause中
-        for(int i = 0; i < clause_ptr->size; i++) {
-            cvec_push(clause, clause_ptr->literals[i]);
+        // 将池中的记录复制到clause中
+        for(int i = 0; i < size; i++) {
+            cvec_push(clause, lits[i]);
         }
-        *lbd = clause_ptr->lbd;
+        *lbd = std::min(rec[1], size);
+        *producer = rec[0];
         return 1;
     }
 
-    moodycamel::ConcurrentQueue<std::shared_ptr<Clause>> import_clause_queue;
-    std::vector<std::shared_ptr<Clause>> learned_clause;
+    ClausePool* clause_pool = nullptr;
+
+    // 读取预处理后公式的求解器到原始变量空间的映射，以及导入时的翻译缓冲
+    std::atomic<const VariableMap*> mapping{nullptr};
+    std::vector<int> translated;
+
+    // 求解器线程写入、分享线程读取的导出缓冲区大小(2^18个int)
+    static const unsigned export_log_size = 18;
 
     kissat* solver;
 
     const int id;
 
     int good_lbd = 2;
+    int export_size = std::numeric_limits<int>::max();
 
-    ExportCallback export_callback;  // 添加回调函数成员变量
+    Statistics *statistics = nullptr;
 
-    // Statistics *statistics;
+    const uint64_t* inactive = nullptr;
+    const uint64_t* usefulness = nullptr;
+    int inactive_vars = 0;
 
 
     bool sbva = false;
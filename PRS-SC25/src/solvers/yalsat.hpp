@@ -5,6 +5,10 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <atomic>
+
+#include "prs/unit_store.hpp"
+#include "utils/formula.hpp"
 
 extern "C" {
     #include "yals.h"
@@ -13,8 +17,11 @@ extern "C" {
 class YalsatSolver {
 private:
     Yals* solver;
-    bool should_terminate;
+    // 由其他线程置位，在yals的终止回调中读取
+    std::atomic<bool> should_terminate;
     int orivars;
+    UnitStore* units = nullptr;
+    unsigned imported_units = 0;
     // 存储最佳相位的成员变量
 
 
@@ -34,7 +41,7 @@ public:
         }
     }
 
-    void read_from_proprocess(preprocess* pre) {
+    void read_from_proprocess(const preprocess* pre) {
         for (int i = 1; i <= pre->clauses; i++) {
             int l = pre->clause[i].size();
             for (int j = 0; j < l; j++)
@@ -44,14 +51,22 @@ public:
         orivars = pre->orivars;
     }
 
-    void read_from_vector(std::vector<std::vector<int>>& clauses, int vars) {
-        for (int i = 0; i < clauses.size(); i++) {
-            int l = clauses[i].size();
-            for (int j = 0; j < l; j++)
-                yals_add(solver, clauses[i][j]);
+    void read_from_formula(const Formula& formula) {
+        for (int i = 0; i < formula.size(); i++) {
+            for (const int* p = formula.begin(i); p != formula.end(i); p++)
+                yals_add(solver, *p);
             yals_add(solver, 0);
         }
-        orivars = vars;
+        orivars = formula.vars;
+    }
+
+    // 从已读入公式的实例克隆，共享只读的子句和出现表，只分配自己的搜索状态。
+    // 回调和随机种子不会拷贝，需在克隆之后设置
+    void read_from_solver(YalsatSolver& loaded) {
+        yals_prepare(loaded.solver);
+        yals_del(solver);
+        solver = yals_clone(loaded.solver);
+        orivars = loaded.orivars;
     }
 
     // 添加一个文字
@@ -61,6 +76,21 @@ public:
         }
     }
 
+    // 连接全局单元文字表，在每次内层重启时导入新的单元，必须在求解开始前调用
+    void setUnitStore(UnitStore* store) {
+        units = store;
+        imported_units = 0;
+        if (solver) {
+            yals_setunits(solver, [](void* ptr) -> int {
+                YalsatSolver* self = static_cast<YalsatSolver*>(ptr);
+                if (self->imported_units == self->units->epoch()) return 0;
+                int lit = self->units->get(self->imported_units);
+                if (lit) self->imported_units++;
+                return lit;
+            }, this);
+        }
+    }
+
     // 设置随机种子
     void setRandomSeed(unsigned long long seed) {
         if (solver) {
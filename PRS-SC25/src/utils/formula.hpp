@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+#include "utils/vec.hpp"
+
+// 只读的CSR公式：所有子句的文字连续存放在lits中，第i个子句(从0开始)为
+// lits[offsets[i], offsets[i+1])。预处理结束后构建一次，之后预处理器、
+// Kissat、YalSAT和SBVA都通过const引用读取同一份数据
+class Formula {
+public:
+    int vars = 0;
+
+    Formula() { publish(); }
+    Formula(const Formula&) = delete;
+    Formula& operator=(const Formula&) = delete;
+
+    // 从预处理使用的1下标子句数组构建，读完后释放原数组以降低峰值内存
+    void build(vec<vec<int>>& clause, int clauses, int nvars) {
+        vars = nvars;
+        size_t total = 0;
+        for (int i = 1; i <= clauses; i++) total += clause[i].size();
+        reset(clauses, total);
+        for (int i = 1; i <= clauses; i++) {
+            append(clause[i].data, clause[i].size());
+            clause[i].clear(true);
+        }
+        clause.clear(true);
+        publish();
+    }
+
+    // 从预处理使用的1下标子句数组拷贝，保留原数组供之后的预处理使用
+    void copy(const vec<vec<int>>& clause, int clauses, int nvars) {
+        vars = nvars;
+        size_t total = 0;
+        for (int i = 1; i <= clauses; i++) total += clause[i].size();
+        reset(clauses, total);
+        for (int i = 1; i <= clauses; i++) append(clause[i].data, clause[i].size());
+        publish();
+    }
+
+    // 从SBVA输出的子句列表构建，读完后释放原列表
+    void build(std::vector<std::vector<int>>& clauses, int nvars) {
+        vars = nvars;
+        size_t total = 0;
+        for (auto& c : clauses) total += c.size();
+        reset(clauses.size(), total);
+        for (auto& c : clauses) append(c.data(), c.size());
+        std::vector<std::vector<int>>().swap(clauses);
+        publish();
+    }
+
+    // 直接使用外部的CSR数组(例如映射的缓存文件)，不拷贝；owner负责数组的生命周期
+    void attach(int nvars, int clauses, const size_t* offs, const int* data,
+                std::shared_ptr<const void> owner) {
+        vars = nvars;
+        std::vector<int>().swap(lits);
+        std::vector<size_t>().swap(offsets);
+        storage = std::move(owner);
+        offset_ptr = offs, lit_ptr = data, count = clauses;
+    }
+
+    int size() const { return count; }
+    size_t literals() const { return offset_ptr[count]; }
+
+    const int* begin(int i) const { return lit_ptr + offset_ptr[i]; }
+    const int* end(int i) const { return lit_ptr + offset_ptr[i + 1]; }
+    int clause_size(int i) const { return offset_ptr[i + 1] - offset_ptr[i]; }
+
+    // 原始数组，供批量加载接口直接使用
+    const int* literal_data() const { return lit_ptr; }
+    const size_t* offset_data() const { return offset_ptr; }
+
+private:
+    void reset(size_t clauses, size_t total) {
+        storage.reset();
+        lits.clear(), offsets.clear();
+        lits.reserve(total);
+        offsets.reserve(clauses + 1);
+        offsets.push_back(0);
+        publish();
+    }
+
+    void publish() {
+        lit_ptr = lits.data(), offset_ptr = offsets.data();
+        count = offsets.size() - 1;
+    }
+
+    void append(const int* c, size_t n) {
+        lits.insert(lits.end(), c, c + n);
+        offsets.push_back(lits.size());
+    }
+
+    std::vector<int> lits;
+    std::vector<size_t> offsets{0};
+    std::shared_ptr<const void> storage;
+    const int* lit_ptr;
+    const size_t* offset_ptr;
+    int count;
+};
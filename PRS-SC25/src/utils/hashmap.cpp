@@ -1,82 +1,45 @@
 #include "hashmap.hpp"
-#include <stdio.h>
-#include <stdlib.h>
+#include <string.h>
 
-
-HashMap::HashMap(int sz) {
-    size = sz;
-    table = new HashNode*[sz];
-    for (int i = 0; i < sz; i++) table[i] = NULL;
+HashMap::HashMap(int expected) : ctrl(NULL), slots(NULL), mask(0), count(0), tombs(0), limit(0) {
+    reserve(expected);
 }
 
-int HashMap::get(ll key, int vsign) {
-    int pos = 1ll * key % size;
-    HashNode *pointer = table[pos];
-    while (pointer != NULL) {
-        if (pointer->data.key == key)
-            return pointer->data.val;
-        else
-            pointer = pointer->next;
-    }
-    return vsign;
+HashMap::~HashMap() {
+    delete []ctrl;
+    delete []slots;
 }
 
-void HashMap::erase(ll key) {
-    int pos = 1ll * key % size;
-    HashNode *pointer = table[pos];
-    if (pointer == NULL) return;
-    if (pointer->data.key == key) {
-        table[pos] = pointer->next;
-        delete pointer;
-        return;
-    }
-    HashNode *prev = pointer;
-    pointer = pointer->next;
-    while (pointer != NULL) {
-        if (pointer->data.key == key) {
-            prev->next = pointer->next;
-            delete pointer;
-            return;
-        }
-        prev = pointer;
-        pointer = pointer->next;    
-    };
+// 装载因子不超过7/8
+void HashMap::reserve(int expected) {
+    size_t capacity = GROUP;
+    while (capacity / 8 * 7 <= (size_t)expected) capacity <<= 1;
+    if (capacity > mask + 1) rehash(capacity);
 }
 
-void HashMap::insert(ll key, int value) {
-    HashNode *hnode = new HashNode();
-    hnode->data.key = key;
-    hnode->data.val = value;
-    hnode->next = NULL;
-
-    int pos = 1ll * key % size;
-    if (table[pos] == NULL) {
-        table[pos] = hnode;
-        return;
-    }
-    HashNode *pointer = table[pos];
-    HashNode *prev = pointer;
-    while (pointer != NULL) {
-        if (pointer->data.key == key) {
-            pointer->data.val = value;
-            delete hnode;
-            return;
-        } 
-        prev = pointer;
-        pointer = pointer->next; 
-    } 
-    prev->next = hnode;
+void HashMap::allocate(size_t capacity) {
+    ctrl = new uint8_t[capacity + GROUP];
+    slots = new Slot[capacity];
+    memset(ctrl, EMPTY, capacity + GROUP);
+    mask = capacity - 1;
+    limit = capacity / 8 * 7;
+    count = tombs = 0;
 }
 
-HashMap::~HashMap(){
-    for (int i = 0; i < size; i++) {
-        HashNode *pointer = table[i];
-        HashNode *prev = pointer;
-        while (pointer != NULL){    
-            prev = pointer;
-            pointer = pointer->next;
-            delete prev;
-        }
+// 重新散列时丢弃墓碑，键互不相同，直接放入第一个空槽位
+void HashMap::rehash(size_t capacity) {
+    uint8_t *old_ctrl = ctrl;
+    Slot *old_slots = slots;
+    size_t old_capacity = old_ctrl ? mask + 1 : 0;
+    allocate(capacity);
+    for (size_t j = 0; j < old_capacity; j++) {
+        if (old_ctrl[j] & 0x80) continue;
+        uint64_t h = hash(old_slots[j].key);
+        size_t i = free_slot(h);
+        set_ctrl(i, h & 0x7f);
+        slots[i] = old_slots[j];
+        ++count;
     }
-    delete []table;
-}
\ No newline at end of file
+    delete []old_ctrl;
+    delete []old_slots;
+}
@@ -1,26 +1,140 @@
 #ifndef _hashmap_hpp_INCLUDED
 #define _hashmap_hpp_INCLUDED
-typedef long long ll;
 
-struct DataType{
-	ll key;  
-	int val;  
-};
+#include <cstddef>
+#include <cstdint>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
-struct HashNode{
-	DataType data;
-	struct HashNode *next; 
-};
+typedef long long ll;
 
-struct HashMap{
-	int size;
-	HashNode **table;
-	HashMap(int size = 10000007);
+// 以文字对mapv(a, b)为键的开放寻址哈希表。键和值放在同一个槽位中，控制字节另外连续存放，
+// 每个槽位一个控制字节：EMPTY/DELETED的最高位为1，否则为键的哈希值的低7位。
+// 查找时一次比较16个控制字节，只在标签相同的槽位比较键；删除只留下墓碑，不移动元素。
+// 表中始终保留空槽位，探测一定会结束
+struct HashMap {
+	// expected为预计的元素个数，批量插入之前按实际数目构造可以避免重新散列
+	explicit HashMap(int expected = 0);
 	~HashMap();
-	int  get(ll key, int vsign);
+	HashMap(const HashMap&) = delete;
+	HashMap& operator=(const HashMap&) = delete;
+
+	void reserve(int expected);
+	int  get(ll key, int vsign) const;
 	void erase(ll key);
 	void insert(ll key, int value);
+	int  size() const { return count; }
+
+private:
+	static const int GROUP = 16;
+	static const uint8_t EMPTY = 0x80, DELETED = 0xfe;
+
+	struct Slot {
+		ll key;
+		int val;
+	};
+
+	uint8_t *ctrl;
+	Slot *slots;
+	size_t mask;
+	int count, tombs, limit;
+
+	static uint64_t hash(ll key) {
+		uint64_t h = (uint64_t)key * 0x9e3779b97f4a7c15ull;
+		return h ^ (h >> 29);
+	}
+
+	// 从pos开始的16个控制字节中等于tag的位置，以及最高位为1(空或墓碑)的位置
+	uint32_t match(size_t pos, uint8_t tag) const {
+#ifdef __SSE2__
+		__m128i group = _mm_loadu_si128((const __m128i *)(ctrl + pos));
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)tag)));
+#else
+		uint32_t m = 0;
+		for (int i = 0; i < GROUP; i++) m |= (uint32_t)(ctrl[pos + i] == tag) << i;
+		return m;
+#endif
+	}
+
+	uint32_t match_free(size_t pos) const {
+#ifdef __SSE2__
+		return _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(ctrl + pos)));
+#else
+		uint32_t m = 0;
+		for (int i = 0; i < GROUP; i++) m |= (uint32_t)(ctrl[pos + i] >> 7) << i;
+		return m;
+#endif
+	}
+
+	// 末尾多放GROUP个字节复制表头的控制字节，从任意位置读16个字节都不用回绕
+	void set_ctrl(size_t i, uint8_t c) {
+		ctrl[i] = c;
+		if (i < GROUP) ctrl[i + mask + 1] = c;
+	}
+
+	// 键所在的槽位，不存在时返回-1
+	ptrdiff_t find(ll key) const {
+		uint64_t h = hash(key);
+		uint8_t tag = h & 0x7f;
+		for (size_t pos = (h >> 7) & mask; ; pos = (pos + GROUP) & mask) {
+			for (uint32_t m = match(pos, tag); m; m &= m - 1) {
+				size_t i = (pos + __builtin_ctz(m)) & mask;
+				if (slots[i].key == key) return i;
+			}
+			if (match(pos, EMPTY)) return -1;
+		}
+	}
+
+	// 探测序列上第一个空槽位或墓碑
+	size_t free_slot(uint64_t h) const {
+		size_t pos = (h >> 7) & mask;
+		uint32_t m;
+		while (!(m = match_free(pos))) pos = (pos + GROUP) & mask;
+		return (pos + __builtin_ctz(m)) & mask;
+	}
+
+	void allocate(size_t capacity);
+	void rehash(size_t capacity);
 };
 
+inline int HashMap::get(ll key, int vsign) const {
+	ptrdiff_t i = find(key);
+	return i < 0 ? vsign : slots[i].val;
+}
+
+inline void HashMap::erase(ll key) {
+	ptrdiff_t i = find(key);
+	if (i < 0) return;
+	set_ctrl(i, DELETED);
+	--count, ++tombs;
+}
+
+// 查找键的同时记下探测序列上第一个可用的槽位，键不存在时直接放入，只探测一遍
+inline void HashMap::insert(ll key, int value) {
+	uint64_t h = hash(key);
+	uint8_t tag = h & 0x7f;
+	ptrdiff_t slot = -1;
+	for (size_t pos = (h >> 7) & mask; ; pos = (pos + GROUP) & mask) {
+		for (uint32_t m = match(pos, tag); m; m &= m - 1) {
+			size_t i = (pos + __builtin_ctz(m)) & mask;
+			if (slots[i].key == key) {
+				slots[i].val = value;
+				return;
+			}
+		}
+		uint32_t free = match_free(pos);
+		if (slot < 0 && free) slot = (pos + __builtin_ctz(free)) & mask;
+		if (match(pos, EMPTY)) break;
+	}
+	if (ctrl[slot] == DELETED) --tombs;
+	else if (count + tombs >= limit) {
+		rehash(count >= limit / 2 ? (mask + 1) * 2 : mask + 1);
+		slot = free_slot(h);
+	}
+	set_ctrl(slot, tag);
+	slots[slot].key = key, slots[slot].val = value;
+	++count;
+}
 
-#endif
\ No newline at end of file
+#endif
@@ -1,86 +1,355 @@
-#pragma once
-
-#include <cstring>
-#include <fstream>
-using namespace std;
-
-inline char *read_whitespace(char *p) {
-    while ((*p >= 9 && *p <= 13) || *p == 32)
-        ++p;
-    return p;
-}
-inline char *read_until_new_line(char *p)
-{
-    while (*p != '\n')
-    {
-        if (*p == '\0')
-        {
-            exit(0);
-        }
-        ++p;
-    }
-    return ++p;
-}
-
-inline char *read_int(char *p, int *i)
-{
-    *i = 0;
-    bool sym = true;
-    p = read_whitespace(p);
-    if (*p == '-')
-        sym = false, ++p;
-    while (*p >= '0' && *p <= '9')
-    {
-        if (*p == '\0')
-            return p;
-        *i = *i * 10 + *p - '0';
-        ++p;
-    }
-    if (!sym)
-        *i = -(*i);
-    return p;
-}
-
-inline void readfile(const char *file, int *vars, int *clauses, vec<vec<int>> &clause) {
-    std::string infile(file);
-	std::ifstream fin(infile);
-    fin.seekg(0, fin.end);
-	size_t file_len = fin.tellg();
-	fin.seekg(0, fin.beg);
-	char *data = new char[file_len + 1];
-	fin.read(data, file_len);
-	fin.close();
-	data[file_len] = '\0';
-    char *p = data;
-    clause.push();
-    clause.push();
-    int num_clauses = 1;
-    while (*p != '\0')
-    {   
-        p = read_whitespace(p);
-        if (*p == '\0')
-            break;
-        if (*p == 'c')
-            p = read_until_new_line(p);
-        else if (*p == 'p')
-        {
-            p += 5;
-            p = read_int(p, vars);
-            p = read_int(p, clauses);
-        }
-        else
-        {
-            int dimacs_lit;
-            p = read_int(p, &dimacs_lit);
-            if (*p == '\0' && dimacs_lit != 0) exit(0);
-            if (dimacs_lit == 0)
-                num_clauses += 1, clause.push();
-            else
-                clause[num_clauses].push(dimacs_lit);
-        }
-    }
-    if (num_clauses != *clauses + 1) {
-        *clauses = num_clauses - 1;
-    }
-    delete []data;
-}
+#pragma once
+
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <fstream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "utils/vec.hpp"
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// 并行DIMACS解析：文件整体mmap进来，按子句边界切成若干块，每个线程用SWAR
+// 一次扫描8个字节的数字，最后把各块的结果按顺序拼接成1下标的子句数组。
+// gz/bz2/xz压缩文件通过管道解压，解压和解析流水线并行
+// ---------------------------------------------------------------------------
+
+// 输入缓冲区：优先mmap，失败时(管道等)整体读入内存
+struct InputBuffer {
+    const char *begin = nullptr, *end = nullptr;
+    size_t mapped = 0;
+    char *owned = nullptr;
+
+    ~InputBuffer() {
+        if (mapped) munmap((void *)begin, mapped);
+        delete []owned;
+    }
+
+    bool open(const char *file) {
+        int fd = ::open(file, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                madvise(p, st.st_size, MADV_WILLNEED);
+                close(fd);
+                mapped = st.st_size;
+                begin = (const char *)p, end = begin + mapped;
+                return true;
+            }
+        }
+        size_t cap = 1 << 20, len = 0;
+        owned = new char[cap];
+        ssize_t n;
+        while ((n = ::read(fd, owned + len, cap - len)) > 0) {
+            len += n;
+            if (len == cap) {
+                char *grown = new char[cap * 2];
+                memcpy(grown, owned, len);
+                delete []owned;
+                owned = grown, cap *= 2;
+            }
+        }
+        close(fd);
+        begin = owned, end = owned + len;
+        return true;
+    }
+};
+
+inline bool is_space(char c) { return (c >= 9 && c <= 13) || c == 32; }
+
+inline const char *skip_line(const char *p, const char *end) {
+    const char *nl = (const char *)memchr(p, '\n', end - p);
+    return nl ? nl + 1 : end;
+}
+
+// 从p开始解析一串十进制数字，p + 8 <= end时每次处理8个字节
+inline const char *scan_digits(const char *p, const char *end, uint64_t &value) {
+    value = 0;
+    while (p + 8 <= end) {
+        uint64_t x;
+        memcpy(&x, p, 8);
+        // 每个字节异或'0'后，数字字节落在0..9，其余字节的最高位或加0x76后的最高位为1
+        uint64_t y = x ^ 0x3030303030303030ull;
+        uint64_t stop = ((y + 0x7676767676767676ull) | y) & 0x8080808080808080ull;
+        int len = stop ? __builtin_ctzll(stop) >> 3 : 8;
+        if (!len) return p;
+        // 把len个数字移到高位，低位补0，再两两、四四、八八合并
+        uint64_t v = (y << (8 * (8 - len))) & 0x0f0f0f0f0f0f0f0full;
+        v = (v * 10 + (v >> 8)) & 0x00ff00ff00ff00ffull;
+        v = (v * 100 + (v >> 16)) & 0x0000ffff0000ffffull;
+        v = (v * 10000 + (v >> 32)) & 0x00000000ffffffffull;
+        static const uint64_t pow10[9] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+        value = value * pow10[len] + v;
+        p += len;
+        if (len < 8) return p;
+    }
+    while (p < end && *p >= '0' && *p <= '9') value = value * 10 + (*p++ - '0');
+    return p;
+}
+
+// 一个块的解析结果：以0结尾的文字序列和子句数。open表示最后一个子句还没有
+// 遇到0，流式解析时下一段输入接着这个子句继续
+struct ParsedChunk {
+    std::vector<int> lits;
+    int clauses = 0;
+    bool open = false;
+    int vars = -1, declared = -1;
+};
+
+// 解析p cnf行中的变量数和子句数
+inline void parse_header(const char *p, const char *end, ParsedChunk &out) {
+    uint64_t v;
+    const char *q = p + 1;
+    while (q < end && *q != '\n' && (*q < '0' || *q > '9')) ++q;
+    q = scan_digits(q, end, v), out.vars = v;
+    while (q < end && is_space(*q) && *q != '\n') ++q;
+    q = scan_digits(q, end, v), out.declared = v;
+}
+
+inline void parse_chunk(const char *p, const char *end, ParsedChunk &out) {
+    if (out.lits.empty()) out.lits.reserve((end - p) / 4);
+    bool open = out.open;
+    while (p < end) {
+        char c = *p;
+        if (is_space(c)) { ++p; continue; }
+        bool neg = c == '-';
+        if (neg) ++p;
+        if (p == end || *p < '0' || *p > '9') {
+            // 注释行以及无法识别的行整行跳过
+            if (c == 'p') parse_header(p, end, out);
+            p = skip_line(p, end);
+            continue;
+        }
+        uint64_t v;
+        p = scan_digits(p, end, v);
+        int lit = neg ? -(int)v : (int)v;
+        out.lits.push_back(lit);
+        if (lit) open = true;
+        else open = false, out.clauses++;
+    }
+    out.open = open;
+}
+
+// 从pos所在行的下一行开始找到第一个作为独立记号的0，返回其后的位置作为块边界
+inline const char *next_clause_boundary(const char *pos, const char *begin, const char *end) {
+    const char *p = pos == begin ? pos : skip_line(pos, end);
+    while (p < end) {
+        char c = *p;
+        if (is_space(c)) { ++p; continue; }
+        if (c == '-') ++p;
+        if (p == end || *p < '0' || *p > '9') { p = skip_line(p, end); continue; }
+        uint64_t v;
+        p = scan_digits(p, end, v);
+        if (!v && c != '-') return p;
+    }
+    return end;
+}
+
+// 按魔数识别压缩文件，与kissat的file.c一样交给外部解压程序，返回程序名
+inline const char *decompressor(const char *file) {
+    unsigned char magic[6] = {0};
+    FILE *f = fopen(file, "rb");
+    if (!f) return nullptr;
+    size_t n = fread(magic, 1, sizeof magic, f);
+    fclose(f);
+    if (n >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) return "gzip";
+    if (n >= 3 && !memcmp(magic, "BZh", 3)) return "bzip2";
+    if (n >= 6 && !memcmp(magic, "\xfd" "7zXZ", 6)) return "xz";
+    return nullptr;
+}
+
+// 不经过shell启动"program -c -d file"，文件名作为单独的参数传入，其中的引号和特殊字符不会被解释。
+// 用posix_spawnp而不是fork，读入时其他线程可能已经在运行。返回解压输出的读端，失败时返回nullptr
+inline FILE *spawn_decompressor(const char *program, const char *file, pid_t &pid) {
+    int fd[2];
+    if (pipe(fd)) return nullptr;
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fd[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, fd[0]);
+    posix_spawn_file_actions_addclose(&actions, fd[1]);
+    char *argv[] = {(char *)program, (char *)"-c", (char *)"-d", (char *)file, nullptr};
+    int err = posix_spawnp(&pid, program, &actions, nullptr, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fd[1]);
+    if (err) {
+        close(fd[0]);
+        return nullptr;
+    }
+    return fdopen(fd[0], "r");
+}
+
+// 关闭读端并等待解压程序结束，正常退出时返回true
+inline bool wait_decompressor(FILE *pipe, pid_t pid) {
+    fclose(pipe);
+    int status;
+    while (waitpid(pid, &status, 0) < 0)
+        if (errno != EINTR) return false;
+    return WIFEXITED(status) && !WEXITSTATUS(status);
+}
+
+// 流式解析：读线程从管道按块读入解压后的数据，解析线程同时解析已到达的块，
+// 每块只解析到最后一个换行，剩下的半行留给下一块。返回解压后的字节数
+inline size_t parse_stream(FILE *pipe, ParsedChunk &out) {
+    const size_t BLOCK = 4 << 20, DEPTH = 4;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::string> blocks;
+    bool done = false;
+
+    std::thread reader([&] {
+        while (true) {
+            std::string block(BLOCK, '\0');
+            size_t n = fread(&block[0], 1, BLOCK, pipe);
+            block.resize(n);
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return blocks.size() < DEPTH; });
+            if (n) blocks.push_back(std::move(block));
+            if (n < BLOCK) done = true;
+            cv.notify_all();
+            if (done) break;
+        }
+    });
+
+    size_t total = 0;
+    std::string carry;
+    while (true) {
+        std::string block;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return !blocks.empty() || done; });
+            if (blocks.empty()) break;
+            block = std::move(blocks.front());
+            blocks.pop_front();
+            cv.notify_all();
+        }
+        total += block.size();
+        carry += block;
+        size_t cut = carry.rfind('\n');
+        if (cut == std::string::npos) continue;
+        parse_chunk(carry.data(), carry.data() + cut + 1, out);
+        carry.erase(0, cut + 1);
+    }
+    reader.join();
+    parse_chunk(carry.data(), carry.data() + carry.size(), out);
+    return total;
+}
+
+// 把各块的文字序列按顺序拼成clause[1..n]，与原来的接口保持一致，首尾各有一个空子句
+inline int stitch_chunks(std::vector<ParsedChunk> &parsed, vec<vec<int>> &clause) {
+    int chunks = parsed.size();
+    std::vector<int> first(chunks + 1);
+    first[0] = 1;
+    for (int i = 0; i < chunks; i++) first[i + 1] = first[i] + parsed[i].clauses;
+    int num_clauses = first[chunks] - 1;
+
+    clause.capacity(num_clauses + 2);
+    while (clause.size() < num_clauses + 2) clause.push();
+
+    auto stitch = [&](int i) {
+        const std::vector<int> &lits = parsed[i].lits;
+        int c = first[i];
+        size_t j = 0;
+        while (j < lits.size()) {
+            size_t k = j;
+            while (lits[k]) k++;
+            vec<int> &cls = clause[c++];
+            cls.capacity(k - j);
+            for (; j < k; j++) cls.push_(lits[j]);
+            j++;
+        }
+        std::vector<int>().swap(parsed[i].lits);
+    };
+    std::vector<std::thread> workers;
+    for (int i = 1; i < chunks; i++) workers.emplace_back(stitch, i);
+    stitch(0);
+    for (auto &t : workers) t.join();
+    return num_clauses;
+}
+
+inline void readfile(const char *file, int *vars, int *clauses, vec<vec<int>> &clause, int threads = 0) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<ParsedChunk> parsed;
+    size_t bytes;
+    const char *command = decompressor(file);
+
+    if (command) {
+        pid_t pid;
+        FILE *pipe = spawn_decompressor(command, file, pid);
+        if (!pipe) {
+            printf("c cannot run %s -c -d %s\n", command, file);
+            exit(0);
+        }
+        parsed.resize(1);
+        bytes = parse_stream(pipe, parsed[0]);
+        if (!wait_decompressor(pipe, pid)) {
+            printf("c decompression with %s -c -d %s failed\n", command, file);
+            exit(0);
+        }
+    } else {
+        InputBuffer in;
+        if (!in.open(file)) {
+            printf("c cannot open %s\n", file);
+            exit(0);
+        }
+        const char *p = in.begin, *end = in.end;
+        bytes = end - p;
+
+        // 按线程数切块，块太小时减少块数
+        const size_t MIN_CHUNK = 1 << 20;
+        if (threads <= 0) threads = std::thread::hardware_concurrency();
+        int chunks = bytes / MIN_CHUNK < (size_t)threads ? bytes / MIN_CHUNK : threads;
+        if (chunks < 1) chunks = 1;
+        std::vector<const char *> bounds(chunks + 1);
+        bounds[0] = p, bounds[chunks] = end;
+        for (int i = 1; i < chunks; i++) {
+            const char *target = p + bytes / chunks * i;
+            if (target < bounds[i - 1]) target = bounds[i - 1];
+            bounds[i] = next_clause_boundary(target, p, end);
+        }
+
+        parsed.resize(chunks);
+        std::vector<std::thread> workers;
+        for (int i = 1; i < chunks; i++)
+            workers.emplace_back(parse_chunk, bounds[i], bounds[i + 1], std::ref(parsed[i]));
+        parse_chunk(bounds[0], bounds[1], parsed[0]);
+        for (auto &t : workers) t.join();
+    }
+
+    // 只有最后一块可能有未以0结尾的子句
+    for (auto &chunk : parsed)
+        if (chunk.open) exit(0);
+
+    // 注释很长时p cnf行可能落在后面的块里，取第一个解析到的文件头
+    *vars = 0;
+    for (auto &chunk : parsed)
+        if (chunk.vars >= 0) { *vars = chunk.vars; break; }
+    *clauses = stitch_chunks(parsed, clause);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double mb = bytes / 1048576.0;
+    if (command)
+        printf("c parsed %.1f MB streamed from %s in %.2f seconds (%.1f MB/s)\n",
+               mb, command, seconds, seconds > 0 ? mb / seconds : 0.0);
+    else
+        printf("c parsed %.1f MB in %.2f seconds (%.1f MB/s, %d threads)\n",
+               mb, seconds, seconds > 0 ? mb / seconds : 0.0, (int)parsed.size());
+}
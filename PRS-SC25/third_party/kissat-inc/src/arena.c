@@ -22,6 +22,36 @@ report_resized (kissat * solver, const char *mode, arena before)
 #endif
 }
 
+static void
+enlarge_arena (kissat * solver, size_t needed)
+{
+  const size_t size = SIZE_STACK (solver->arena);
+  size_t capacity = CAPACITY_STACK (solver->arena);
+  assert (kissat_is_power_of_two (MAX_ARENA));
+  assert (capacity <= MAX_ARENA);
+  size_t available = capacity - size;
+  if (needed <= available)
+    return;
+  const arena before = solver->arena;
+  do
+    {
+      assert (kissat_is_zero_or_power_of_two (capacity));
+      if (capacity == MAX_ARENA)
+	kissat_fatal ("maximum arena capacity "
+		      "of 2^%d words %s exhausted",
+		      LD_MAX_ARENA, FORMAT_BYTES (MAX_ARENA * sizeof (word)));
+      kissat_stack_enlarge (solver, (chars *) & solver->arena,
+			    sizeof (word));
+      capacity = CAPACITY_STACK (solver->arena);
+      available = capacity - size;
+    }
+  while (needed > available);
+  INC (arena_resized);
+  INC (arena_enlarged);
+  report_resized (solver, "enlarged", before);
+  assert (capacity <= MAX_ARENA);
+}
+
 reference
 kissat_allocate_clause (kissat * solver, size_t size)
 {
@@ -32,38 +62,20 @@ kissat_allocate_clause (kissat * solver, size_t size)
   assert (kissat_aligned_word (bytes));
   const size_t needed = bytes / sizeof (word);
   assert (needed <= UINT_MAX);
-  size_t capacity = CAPACITY_STACK (solver->arena);
-  assert (kissat_is_power_of_two (MAX_ARENA));
-  assert (capacity <= MAX_ARENA);
-  size_t available = capacity - res;
-  if (needed > available)
-    {
-      const arena before = solver->arena;
-      do
-	{
-	  assert (kissat_is_zero_or_power_of_two (capacity));
-	  if (capacity == MAX_ARENA)
-	    kissat_fatal ("maximum arena capacity "
-			  "of 2^%d words %s exhausted",
-			  LD_MAX_ARENA,
-			  FORMAT_BYTES (MAX_ARENA * sizeof (word)));
-	  kissat_stack_enlarge (solver, (chars *) & solver->arena,
-				sizeof (word));
-	  capacity = CAPACITY_STACK (solver->arena);
-	  available = capacity - res;
-	}
-      while (needed > available);
-      INC (arena_resized);
-      INC (arena_enlarged);
-      report_resized (solver, "enlarged", before);
-      assert (capacity <= MAX_ARENA);
-    }
+  enlarge_arena (solver, needed);
   solver->arena.end += needed;
   LOG ("allocated clause[%u] of size %zu bytes %s",
        res, size, FORMAT_BYTES (bytes));
   return res;
 }
 
+void
+kissat_reserve_arena (kissat * solver, size_t words)
+{
+  LOG ("reserving %zu arena words", words);
+  enlarge_arena (solver, words);
+}
+
 void
 kissat_shrink_arena (kissat * solver)
 {
@@ -18,6 +18,7 @@ struct clause;
 struct kissat;
 
 reference kissat_allocate_clause (struct kissat *, size_t size);
+void kissat_reserve_arena (struct kissat *, size_t words);
 void kissat_shrink_arena (struct kissat *);
 
 #if !defined(NDEBUG) || defined(LOGGING)
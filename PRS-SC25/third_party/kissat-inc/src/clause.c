@@ -50,6 +50,7 @@ init_clause (kissat * solver, clause * res,
   res->swept = false;
 
   res->used = 0;
+  res->shared = 0;
 
   res->searched = 2;
   res->size = size;
@@ -154,6 +155,17 @@ kissat_new_original_clause (kissat * solver)
   return res;
 }
 
+reference
+kissat_new_reserved_original_clause (kissat * solver,
+				     unsigned size, unsigned *lits)
+{
+  assert (size > 1);
+  assert (!solver->level);
+  if (size == 2)
+    return new_binary_clause (solver, true, false, lits[0], lits[1]);
+  return new_large_clause (solver, true, false, 0, size, lits);
+}
+
 reference
 kissat_new_irredundant_clause (kissat * solver)
 {
@@ -27,6 +27,7 @@ struct clause
   bool vivify:1;
   
   unsigned used:2;
+  unsigned shared:8;
 
   unsigned searched;
   unsigned size;
@@ -75,6 +76,8 @@ void kissat_new_binary_clause (struct kissat *,
 			       bool redundant, unsigned, unsigned);
 
 reference kissat_new_original_clause (struct kissat *);
+reference kissat_new_reserved_original_clause (struct kissat *,
+					       unsigned size, unsigned *);
 reference kissat_new_irredundant_clause (struct kissat *);
 reference kissat_new_redundant_clause (struct kissat *, unsigned glue);
 
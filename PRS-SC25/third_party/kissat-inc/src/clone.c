@@ -0,0 +1,177 @@
+#include "allocate.h"
+#include "error.h"
+#include "inline.h"
+#include "prs.h"
+#include "require.h"
+#include "resize.h"
+
+#include <string.h>
+
+// Cloning copies the clause database of a solver which has been loaded
+// but has not started searching into a freshly initialized solver.  The
+// clone keeps its own options and callbacks.  Variable indices, the arena
+// and root level assignments are taken over verbatim, while the variable
+// queue and the scores heaps are rebuilt in the activation order the clone
+// would have used if it had read the formula itself ('order_reset').
+
+#define COPY_VARIABLE_INDEXED(NAME) \
+do { \
+  memcpy (solver->NAME, source->NAME, \
+          source->vars * sizeof *solver->NAME); \
+} while (0)
+
+#define COPY_LITERAL_INDEXED(NAME) \
+do { \
+  memcpy (solver->NAME, source->NAME, \
+          2 * source->vars * sizeof *solver->NAME); \
+} while (0)
+
+static void
+copy_watches (kissat * solver, const kissat * source)
+{
+  const unsigned lits = 2 * source->vars;
+  size_t entries = 1;
+  for (unsigned lit = 0; lit < lits; lit++)
+    entries += source->watches[lit].size;
+
+  // Watch vectors are copied in literal order without the gaps of the
+  // source stack, which thus results in a defragmented copy.
+
+  unsigneds *stack = &solver->vectors.stack;
+  assert (EMPTY_STACK (*stack));
+  while (CAPACITY_STACK (*stack) < entries)
+    kissat_stack_enlarge (solver, (chars *) stack, sizeof (unsigned));
+
+  unsigned *begin = BEGIN_STACK (*stack), *p = begin;
+  const unsigned *source_begin = BEGIN_STACK (source->vectors.stack);
+  *p++ = 0;
+  for (unsigned lit = 0; lit < lits; lit++)
+    {
+      const vector *from = source->watches + lit;
+      vector *to = solver->watches + lit;
+      to->size = from->size;
+      if (!from->size)
+	{
+	  to->offset = 0;
+	  continue;
+	}
+      to->offset = p - begin;
+      memcpy (p, source_begin + from->offset, from->size * sizeof *p);
+      p += from->size;
+    }
+  stack->end = p;
+  solver->vectors.usable = 0;
+  kissat_check_vectors (solver);
+}
+
+static void
+activate_variable (kissat * solver, const kissat * source, unsigned idx)
+{
+  if (!source->flags[idx].active)
+    return;
+  kissat_activate_literal (solver, LIT (idx));
+}
+
+static void
+activate_variables (kissat * solver, const kissat * source)
+{
+  const int seed = GET_OPTION (order_reset);
+  if (seed != -1)
+    {
+      // Same rotated external order as 'kissat_init_shuffle'.
+
+      const import *imports = BEGIN_STACK (source->import);
+      const int max_var = (int) SIZE_STACK (source->import) - 1;
+      const int threads = GET_OPTION (threads);
+      const int start = max_var / threads * seed;
+      for (int round = 0; round < 2; round++)
+	{
+	  const int first = round ? 1 : start + 1;
+	  const int last = round ? start : max_var;
+	  for (int eidx = first; eidx <= last; eidx++)
+	    {
+	      const import *import = imports + eidx;
+	      if (import->imported && !import->eliminated)
+		activate_variable (solver, source, IDX (import->lit));
+	    }
+	}
+    }
+
+  // Variables not reached above, and all variables without seed, are
+  // activated in the enqueue order of the source.
+
+  for (unsigned idx = source->queue.first; !DISCONNECTED (idx);
+       idx = source->links[idx].next)
+    activate_variable (solver, source, idx);
+}
+
+void
+kissat_clone (kissat * solver, const kissat * source)
+{
+  kissat_require_initialized (solver);
+  kissat_require_initialized (source);
+  kissat_require (!solver->vars && EMPTY_STACK (solver->import),
+		  "clone target already has variables");
+  kissat_require (!GET (searches), "incremental solving not supported");
+  kissat_require (!source->statistics.searches,
+		  "can not clone solver after solving started");
+  kissat_require (EMPTY_STACK (source->clause.lits),
+		  "incomplete clause in source (terminating zero not added)");
+#ifndef NPROOFS
+  kissat_require (!solver->proof && !source->proof,
+		  "can not clone solvers with proofs");
+#endif
+#ifndef NDEBUG
+  kissat_require (!GET_OPTION (check) && !source->options.check,
+		  "can not clone checked solvers");
+#endif
+  assert (!source->level);
+  assert (source->propagated == SIZE_STACK (source->trail));
+
+  LOG ("cloning %u variables", source->vars);
+
+  kissat_increase_size (solver, source->size);
+  solver->vars = source->vars;
+
+  COPY_VARIABLE_INDEXED (assigned);
+  COPY_VARIABLE_INDEXED (flags);
+  COPY_VARIABLE_INDEXED (phases);
+  COPY_LITERAL_INDEXED (values);
+
+  COPY_STACK (solver->import, source->import);
+  COPY_STACK (solver->exportk, source->exportk);
+  COPY_STACK (solver->units, source->units);
+  COPY_STACK (solver->trail, source->trail);
+  COPY_STACK (solver->eliminated, source->eliminated);
+  COPY_STACK (solver->extend, source->extend);
+  COPY_STACK (solver->arena, source->arena);
+  copy_watches (solver, source);
+
+  solver->propagated = source->propagated;
+  solver->unflushed = source->unflushed;
+  solver->inconsistent = source->inconsistent;
+  solver->first_reducible = source->first_reducible;
+  solver->last_irredundant = source->last_irredundant;
+
+  // Clause counters are taken over, while allocation metrics have to
+  // match what this solver allocated itself.
+
+#ifndef NMETRICS
+  const uint64_t allocated_current = solver->statistics.allocated_current;
+  const uint64_t allocated_max = solver->statistics.allocated_max;
+#endif
+  solver->statistics = source->statistics;
+#ifndef NMETRICS
+  solver->statistics.allocated_current = allocated_current;
+  solver->statistics.allocated_max = allocated_max;
+#endif
+
+  for (all_variables (idx))
+    solver->flags[idx].active = false;
+  activate_variables (solver, source);
+  assert (solver->active == source->active);
+  assert (solver->unassigned == source->unassigned);
+
+  for (all_stack (int, elit, solver->units))
+    kissat_prs_mark_inactive (solver, elit);
+}
@@ -405,8 +405,7 @@ sparse_sweep_garbage_clauses (kissat * solver, bool compact, reference start)
 #if !defined(NDEBUG) || defined(CHECKING_OR_PROVING)
       const unsigned old_size = src->size;
 #endif
-      assert (SIZE_OF_CLAUSE_HEADER == sizeof (unsigned));
-      *(unsigned *) dst = *(unsigned *) src;
+      memmove (dst, src, SIZE_OF_CLAUSE_HEADER);
 
       unsigned *q = dst->lits;
 
@@ -750,8 +749,7 @@ dense_sweep_garbage_clauses (kissat * solver)
       assert (src->size > 1);
       LOGCLS (src, "SRC");
       next = kissat_next_clause (src);
-      assert (SIZE_OF_CLAUSE_HEADER == sizeof (unsigned));
-      *(unsigned *) dst = *(unsigned *) src;
+      memmove (dst, src, SIZE_OF_CLAUSE_HEADER);
       dst->searched = src->searched;
       dst->size = src->size;
       dst->shrunken = false;
@@ -149,10 +149,10 @@ kissat_decide (kissat * solver)
     lit = NOT (lit);
 
   // export decide lit
-  // if(solver->prsDecide) {
-  //   int elit = kissat_export_literal(solver, lit);
-  //   solver->prsDecide(solver->prsDecideState, elit);
-  // }
+  if(solver->prsDecide) {
+    int elit = kissat_export_literal(solver, lit);
+    solver->prsDecide(solver->prsDecideState, elit);
+  }
 
   kissat_push_frame (solver, lit);
   assert (solver->level < SIZE_STACK (solver->frames));
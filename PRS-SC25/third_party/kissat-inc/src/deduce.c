@@ -1,6 +1,7 @@
 #include "deduce.h"
 #include "inline.h"
 #include "promote.h"
+#include "prs.h"
 #include "strengthen.h"
 
 static inline void
@@ -8,6 +9,7 @@ mark_clause_as_used (kissat * solver, clause * c)
 {
   if (!c->redundant)
     return;
+  kissat_prs_mark_useful (solver, c);
   if (!c->hyper && c->keep)
     return;
   const unsigned used = c->used;
@@ -1,4 +1,5 @@
 #include "inline.h"
+#include "prs.h"
 
 static void
 activate_literal (kissat * solver, unsigned lit)
@@ -83,6 +84,7 @@ kissat_mark_fixed_literal (kissat * solver, unsigned lit)
   int elit = kissat_export_literal (solver, lit);
   assert (elit);
   PUSH_STACK (solver->units, elit);
+  kissat_prs_mark_inactive (solver, elit);
   LOG ("pushed external unit literal %d (internal %u)", elit, lit);
 }
 
@@ -112,6 +114,7 @@ kissat_mark_eliminated_variable (kissat * solver, unsigned idx)
   import->eliminated = true;
   PUSH_STACK (solver->eliminated, (value) 0);
   LOG ("marked external variable %u as eliminated", eidx);
+  kissat_prs_mark_inactive (solver, elit);
   assert (solver->unassigned > 0);
   solver->unassigned--;
 }
@@ -1,5 +1,6 @@
 #include "allocate.h"
 #include "backtrack.h"
+#include "collect.h"
 #include "error.h"
 #include "search.h"
 #include "import.h"
@@ -31,7 +32,6 @@ kissat_init (void)
 #endif
   START (total);
   solver->importedClause = cvec_init();
-  solver->exportedClause = cvec_init();
   kissat_init_queue (&solver->queue);
   kissat_push_frame (solver, INVALID_LIT);
   solver->nconflict = 0;
@@ -51,10 +51,15 @@ kissat_init (void)
   solver-> reseting = 0;
 
 // clause sharing
-  solver->exportedClause = cvec_init();
-  solver->importedClause = cvec_init();
-  solver->prsExportClause = NULL;
-  solver->prsExportState = NULL;
+  solver->prsExportRing = NULL;
+  solver->prsInactive = NULL;
+  solver->prsUsefulness = NULL;
+  solver->prsExportUnit = NULL;
+  solver->prsUnitsEpoch = NULL;
+  solver->prsImportUnit = NULL;
+  solver->prsExportEquivalence = NULL;
+  solver->prsEquivalencesEpoch = NULL;
+  solver->prsImportEquivalence = NULL;
   solver->prsImportClause = NULL;
   solver->prsImportState = NULL;
 
@@ -130,7 +135,15 @@ kissat_release (kissat * solver)
 
   // 释放导入的子句
   cvec_release(solver->importedClause);
-  cvec_release(solver->exportedClause);
+  if (solver->prsUsefulness)
+    kissat_free (solver, solver->prsUsefulness,
+                 2 * solver->prsProducers * sizeof (uint64_t));
+  if (solver->prsInactive)
+    kissat_free (solver, solver->prsInactive,
+                 (solver->prsInactiveVars / 64 + 1) * sizeof (uint64_t));
+  if (solver->prsExportRing)
+    kissat_free (solver, solver->prsExportRing,
+                 (solver->prsExportMask + 1) * sizeof (int));
 
   RELEASE_STACK (solver->import);
   RELEASE_STACK (solver->eliminated);
@@ -309,6 +322,78 @@ kissat_print_statistics (kissat * solver)
   (void) solver;
 }
 
+static inline void
+add_original_literal (kissat * solver, int elit, unsigned ilit)
+{
+  const mark mark = MARK (ilit);
+  if (!mark)
+    {
+      const value value = kissat_fixed (solver, ilit);
+      if (value > 0)
+	{
+	  if (!solver->clause.satisfied)
+	    {
+	      LOG ("adding root level satisfied literal %u(%d)@0=1",
+		   ilit, elit);
+	      solver->clause.satisfied = true;
+	    }
+	}
+      else if (value < 0)
+	{
+	  LOG ("adding root level falsified literal %u(%d)@0=-1",
+	       ilit, elit);
+	  if (!solver->clause.shrink)
+	    {
+	      solver->clause.shrink = true;
+	      LOG ("thus original clause needs shrinking");
+	    }
+	}
+      else
+	{
+	  MARK (ilit) = 1;
+	  MARK (NOT (ilit)) = -1;
+	  assert (SIZE_STACK (solver->clause.lits) < UINT_MAX);
+	  PUSH_STACK (solver->clause.lits, ilit);
+	}
+    }
+  else if (mark < 0)
+    {
+      assert (mark < 0);
+      if (!solver->clause.trivial)
+	{
+	  LOG ("adding dual literal %u(%d) and %u(%d)",
+	       NOT (ilit), -elit, ilit, elit);
+	  solver->clause.trivial = true;
+	}
+    }
+  else
+    {
+      assert (mark > 0);
+      LOG ("adding duplicated literal %u(%d)", ilit, elit);
+      if (!solver->clause.shrink)
+	{
+	  solver->clause.shrink = true;
+	  LOG ("thus original clause needs shrinking");
+	}
+    }
+#ifndef LOGGING
+  (void) elit;
+#endif
+}
+
+static inline void
+reset_original_clause (kissat * solver)
+{
+  for (all_stack (unsigned, lit, solver->clause.lits))
+    MARK (lit) = MARK (NOT (lit)) = 0;
+
+  CLEAR_STACK (solver->clause.lits);
+
+  solver->clause.satisfied = false;
+  solver->clause.trivial = false;
+  solver->clause.shrink = 0;
+}
+
 void
 kissat_add (kissat * solver, int elit)
 {
@@ -328,57 +413,7 @@ kissat_add (kissat * solver, int elit)
 #endif
       unsigned ilit = kissat_import_literal (solver, elit);
 
-      const mark mark = MARK (ilit);
-      if (!mark)
-	{
-	  const value value = kissat_fixed (solver, ilit);
-	  if (value > 0)
-	    {
-	      if (!solver->clause.satisfied)
-		{
-		  LOG ("adding root level satisfied literal %u(%d)@0=1",
-		       ilit, elit);
-		  solver->clause.satisfied = true;
-		}
-	    }
-	  else if (value < 0)
-	    {
-	      LOG ("adding root level falsified literal %u(%d)@0=-1",
-		   ilit, elit);
-	      if (!solver->clause.shrink)
-		{
-		  solver->clause.shrink = true;
-		  LOG ("thus original clause needs shrinking");
-		}
-	    }
-	  else
-	    {
-	      MARK (ilit) = 1;
-	      MARK (NOT (ilit)) = -1;
-	      assert (SIZE_STACK (solver->clause.lits) < UINT_MAX);
-	      PUSH_STACK (solver->clause.lits, ilit);
-	    }
-	}
-      else if (mark < 0)
-	{
-	  assert (mark < 0);
-	  if (!solver->clause.trivial)
-	    {
-	      LOG ("adding dual literal %u(%d) and %u(%d)",
-		   NOT (ilit), -elit, ilit, elit);
-	      solver->clause.trivial = true;
-	    }
-	}
-      else
-	{
-	  assert (mark > 0);
-	  LOG ("adding duplicated literal %u(%d)", ilit, elit);
-	  if (!solver->clause.shrink)
-	    {
-	      solver->clause.shrink = true;
-	      LOG ("thus original clause needs shrinking");
-	    }
-	}
+      add_original_literal (solver, elit, ilit);
     }
   else
     {
@@ -559,15 +594,122 @@ kissat_add (kissat * solver, int elit)
 	  solver->offset_of_last_original_clause = 0;
 	}
 #endif
-      for (all_stack (unsigned, lit, solver->clause.lits))
-	  MARK (lit) = MARK (NOT (lit)) = 0;
+      reset_original_clause (solver);
+    }
+}
 
-      CLEAR_STACK (solver->clause.lits);
+static void
+add_clauses_one_by_one (kissat * solver, size_t clauses,
+			const size_t *offsets, const int *elits)
+{
+  for (size_t i = 0; i < clauses; i++)
+    {
+      const int *end = elits + offsets[i + 1];
+      for (const int *p = elits + offsets[i]; p != end; p++)
+	kissat_add (solver, *p);
+      kissat_add (solver, 0);
+    }
+}
 
-      solver->clause.satisfied = false;
-      solver->clause.trivial = false;
-      solver->clause.shrink = 0;
+void
+kissat_add_clauses (kissat * solver, size_t clauses,
+		    const size_t *offsets, const int *elits)
+{
+  kissat_require_initialized (solver);
+  kissat_require (!GET (searches), "incremental solving not supported");
+  kissat_require (EMPTY_STACK (solver->clause.lits),
+		  "incomplete clause (terminating zero not added)");
+  kissat_require (clauses < UINT_MAX, "too many clauses");
+  assert (!solver->level);
+
+  bool bulk = solver->watching;
+#if !defined(NDEBUG) || !defined(NPROOFS) || defined(LOGGING)
+  if (kissat_checking (solver) || kissat_logging (solver) ||
+      kissat_proving (solver))
+    bulk = false;
+#endif
+  if (!bulk)
+    {
+      add_clauses_one_by_one (solver, clauses, offsets, elits);
+      return;
+    }
+
+  LOG ("adding %zu original clauses in bulk", clauses);
+
+  // The counting pass normalizes every clause exactly as 'kissat_add' would,
+  // but only to count the watches of its first two literals and the arena
+  // words it will need.  Nothing is added and no literal is assigned yet,
+  // so the normalized clause is the one the adding pass will see unless a
+  // unit found in between assigned one of its literals.
+
+  unsigneds extra;
+  INIT_STACK (extra);
+  size_t words = 0;
+
+  for (size_t i = 0; i < clauses; i++)
+    {
+      const int *end = elits + offsets[i + 1];
+      for (const int *p = elits + offsets[i]; p != end; p++)
+	{
+	  const int elit = *p;
+	  kissat_require (elit, "zero literal in clause %zu", i);
+	  kissat_require_valid_external_internal (elit);
+	  const unsigned ilit = kissat_import_literal (solver, elit);
+	  add_original_literal (solver, elit, ilit);
+	}
+      const unsigned size = SIZE_STACK (solver->clause.lits);
+      if (!solver->inconsistent && !solver->clause.satisfied &&
+	  !solver->clause.trivial && size > 1)
+	{
+	  const unsigned *lits = BEGIN_STACK (solver->clause.lits);
+	  const unsigned watched = MAX (lits[0], lits[1]);
+	  while (SIZE_STACK (extra) <= watched)
+	    PUSH_STACK (extra, 0);
+	  const unsigned delta = size == 2 ? 1 : 2;
+	  POKE_STACK (extra, lits[0], PEEK_STACK (extra, lits[0]) + delta);
+	  POKE_STACK (extra, lits[1], PEEK_STACK (extra, lits[1]) + delta);
+	  if (size > 2)
+	    words += kissat_bytes_of_clause (size) / sizeof (word);
+	}
+      reset_original_clause (solver);
+    }
+
+  while (SIZE_STACK (extra) < LITS)
+    PUSH_STACK (extra, 0);
+  kissat_reserve_arena (solver, words);
+  kissat_reserve_vectors (solver, &solver->vectors,
+			  LITS, solver->watches, BEGIN_STACK (extra));
+  RELEASE_STACK (extra);
+
+  // The adding pass reads the clauses straight from 'offsets' and 'elits'
+  // again.  Clauses which still normalize to the counted literals are
+  // added into the reserved arena and watches.  Empty clauses, units and
+  // clauses hitting a literal assigned by such a unit in the meantime are
+  // finished through 'kissat_add' which shrinks or skips them.
+
+  for (size_t i = 0; !solver->inconsistent && i < clauses; i++)
+    {
+      const int *end = elits + offsets[i + 1];
+      for (const int *p = elits + offsets[i]; p != end; p++)
+	{
+	  const int elit = *p;
+	  const unsigned ilit = kissat_import_literal (solver, elit);
+	  add_original_literal (solver, elit, ilit);
+	}
+      const unsigned size = SIZE_STACK (solver->clause.lits);
+      if (solver->clause.satisfied || solver->clause.trivial ||
+	  solver->clause.shrink || size < 2)
+	{
+	  kissat_add (solver, 0);
+	  continue;
+	}
+      unsigned *lits = BEGIN_STACK (solver->clause.lits);
+      kissat_activate_literals (solver, size, lits);
+      (void) kissat_new_reserved_original_clause (solver, size, lits);
+      reset_original_clause (solver);
     }
+
+  kissat_defrag_watches_if_needed (solver);
 }
 
 int
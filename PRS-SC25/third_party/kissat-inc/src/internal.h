@@ -73,15 +73,43 @@ typedef STACK (watch *) patches;
 
 struct kissat
 {
-  // 导出学习子句的回调函数和状态
-  prs_export_clause_callback prsExportClause;
-  void* prsExportState;
-  cvec* exportedClause;
+  // 导出学习子句的环形缓冲区，求解器线程写head，分享线程写tail
+  int* prsExportRing;
+  unsigned prsExportMask;
+  int prsExportGlue;
+  int prsExportSize;
+  uint64_t prsExportHead;
+  uint64_t prsExportTail;
+
+  // 全局单元文字表的回调函数和已导入的单元数
+  prs_export_unit_callback prsExportUnit;
+  prs_units_epoch_callback prsUnitsEpoch;
+  prs_import_unit_callback prsImportUnit;
+  void* prsUnitState;
+  unsigned prsUnitsImported;
+
+  // 全局等价文字表的回调函数、已导入的合并数和替换调度
+  prs_export_equivalence_callback prsExportEquivalence;
+  prs_equivalences_epoch_callback prsEquivalencesEpoch;
+  prs_import_equivalence_callback prsImportEquivalence;
+  void* prsEquivalenceState;
+  unsigned prsEquivalencesImported;
+  bool prsSubstitute;
+  uint64_t prs_substitute_conflicts;
+
+  // 已失效的外部变量位图
+  uint64_t* prsInactive;
+  unsigned prsInactiveVars;
+
+  // 导入子句有用性计数
+  uint64_t* prsUsefulness;
+  unsigned prsProducers;
 
   // 导入学习子句的回调函数和状态
   prs_import_clause_callback prsImportClause;
   void* prsImportState;
   cvec* importedClause;
+  uint64_t prs_import_conflicts;
 
   // 决策变量的回调函数和状态
   prs_decide_callback prsDecide;
@@ -3,6 +3,9 @@
 
 #include "cvec.h"
 
+#include <stddef.h>
+#include <stdint.h>
+
 typedef struct kissat kissat;
 
 // Default (partial) IPASIR interface.
@@ -22,6 +25,17 @@ void kissat_set_terminate (kissat * solver,
 
 void kissat_reserve (kissat * solver, int max_var);
 
+// 批量添加原始子句，子句按CSR格式给出：第i个子句为
+// lits[offsets[i], offsets[i+1])，不含结尾的0。与逐个调用kissat_add等价，
+// 但预先按已知大小预留子句区和监视表空间
+void kissat_add_clauses (kissat * solver, size_t clauses,
+			 const size_t *offsets, const int *lits);
+
+// 把已加载公式但尚未开始求解的source深拷贝到刚创建的solver中，复制变量映射、
+// 子句区、监视表和根层赋值，保留solver自己的选项和回调，并按solver的
+// order_reset重建变量队列和堆。多个solver可以同时从同一个source拷贝
+void kissat_clone (kissat * solver, const kissat * source);
+
 const char *kissat_id (void);
 const char *kissat_version (void);
 const char *kissat_compiler (void);
@@ -38,13 +52,49 @@ void kissat_set_decision_limit (kissat * solver, unsigned);
 
 void kissat_print_statistics (kissat * solver);
 
-// 导出学习子句的回调函数
-typedef void (*prs_export_clause_callback)(void* state, cvec* clause, int glue);
-void kissat_set_prs_export_clause_function(kissat *solver, 
-    prs_export_clause_callback callback, void *state);
+// 导出学习子句的环形缓冲区，容量为2^log_size个int，
+// 每条子句按[glue, size, lit_1, ..., lit_size]连续存放
+void kissat_enable_prs_export(kissat *solver, unsigned log_size);
+
+// 设置导出子句的glue和长度上限，可在求解过程中由其他线程调用
+void kissat_set_prs_export_limit(kissat *solver, int glue, int size);
+
+// 由其他线程批量取出导出的子句：先用available获得可读的int数，
+// 再把这么多个int取到buffer中，保证只包含完整的子句
+size_t kissat_prs_export_available(kissat *solver);
+void kissat_prs_export_clauses(kissat *solver, int *buffer, size_t n);
+
+// 全局单元文字表的回调函数：导出新学到的单元，查询已发布的单元数(epoch)，
+// 按下标读取单元(尚未写好时返回0)。导入时先比较epoch，有新单元才逐个读取
+typedef void (*prs_export_unit_callback)(void* state, int unit);
+typedef unsigned (*prs_units_epoch_callback)(void* state);
+typedef int (*prs_import_unit_callback)(void* state, unsigned index);
+void kissat_set_prs_unit_functions(kissat *solver,
+    prs_export_unit_callback export_unit, prs_units_epoch_callback epoch,
+    prs_import_unit_callback import_unit, void *state);
+
+// 全局等价文字表的回调函数：导出发现的等价文字对，查询已发布的合并数(epoch)，
+// 按下标读取等价文字对(尚未写好时返回0)。导入后触发一次等价替换
+typedef void (*prs_export_equivalence_callback)(void* state, int lit, int other);
+typedef unsigned (*prs_equivalences_epoch_callback)(void* state);
+typedef int (*prs_import_equivalence_callback)(void* state, unsigned index, int *lit, int *other);
+void kissat_set_prs_equivalence_functions(kissat *solver,
+    prs_export_equivalence_callback export_equivalence,
+    prs_equivalences_epoch_callback epoch,
+    prs_import_equivalence_callback import_equivalence, void *state);
+
+// 已失效(固定或消去)的外部变量位图，vars以内的变量由求解器线程置位，
+// 其他线程用原子读检查，用于在分享前跳过会被丢弃的子句
+void kissat_enable_prs_inactive(kissat *solver, int vars);
+const uint64_t *kissat_prs_inactive(kissat *solver);
+
+// 导入子句有用性计数：前producers个计数为各生产者被导入的长子句数，
+// 后producers个为其中在冲突分析中被用到的子句数。由求解器线程递增，其他线程原子读
+void kissat_enable_prs_usefulness(kissat *solver, int producers);
+const uint64_t *kissat_prs_usefulness(kissat *solver);
 
 // 导入学习子句的回调函数
-typedef int (*prs_import_clause_callback)(void* state, cvec* clause, int *glue);
+typedef int (*prs_import_clause_callback)(void* state, cvec* clause, int *glue, int *producer);
 void kissat_set_prs_import_clause_function(kissat *solver,
     prs_import_clause_callback callback, void *state);
 
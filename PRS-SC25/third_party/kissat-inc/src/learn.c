@@ -1,6 +1,8 @@
 #include "backtrack.h"
+#include "import.h"
 #include "inline.h"
 #include "learn.h"
+#include "prs.h"
 #include "reluctant.h"
 
 #include <inttypes.h>
@@ -142,25 +144,134 @@ kissat_learn_clause (kissat * solver)
     learn_reference (solver);
 
   // share clauses
-  if(solver->prsExportClause != NULL) {
-    cvec_clear(solver->exportedClause);
-    unsigned *lits = BEGIN_STACK (solver->clause.lits);
-    const unsigned *end = END_STACK (solver->clause.lits);
-    for (unsigned *p = lits; p != end; p++) {
-      int elit = kissat_export_literal(solver, *p);
-      cvec_push(solver->exportedClause, elit);
+  if (size == 1 && solver->prsExportUnit) {
+    const unsigned unit = PEEK_STACK (solver->clause.lits, 0);
+    solver->prsExportUnit (solver->prsUnitState,
+                           kissat_export_literal (solver, unit));
+  } else if (kissat_prs_exporting (solver, size, glue))
+    kissat_prs_export (solver, size, BEGIN_STACK (solver->clause.lits), glue);
+  
+}
+
+// Attach an imported clause at the current decision level. The watches
+// are chosen against the current trail (true or unassigned literals
+// first, then false literals on the highest level).  We only backtrack
+// if the clause is propagating or conflicting, otherwise it is inserted
+// silently without touching the trail.
+static int
+import_clause (kissat * solver, int glue, int producer)
+{
+  cvec *imported = solver->importedClause;
+  const value *values = solver->values;
+  assigned *all_assigned = solver->assigned;
+
+  // remove root-level falsified literals, skip root-level satisfied clauses
+  int size = 0;
+  for (int k = 0; k < imported->sz; k++) {
+    const unsigned lit = imported->data[k];
+    const value v = values[lit];
+    if (v && !all_assigned[IDX (lit)].level) {
+      if (v > 0)
+        return true;
+      continue;
     }
-    solver->prsExportClause(solver->prsExportState, solver->exportedClause, glue);
+    imported->data[size++] = lit;
   }
-  
+  imported->sz = size;
+
+  if (!size)
+    return false;
+
+  if (size == 1) {
+    const unsigned unit = imported->data[0];
+    if (solver->level)
+      kissat_backtrack (solver, 0);
+    assert (!VALUE (unit));
+    kissat_assign_unit (solver, unit);
+    return true;
+  }
+
+  // move the two best watch candidates to the front
+  const uint64_t max_level = MAX_LEVEL;
+  unsigned *lits = (unsigned *) imported->data;
+  for (int i = 0; i < 2; i++) {
+    int best = i;
+    uint64_t best_rank = 0;
+    for (int k = i; k < size; k++) {
+      const unsigned lit = lits[k];
+      const value v = values[lit];
+      const uint64_t level = all_assigned[IDX (lit)].level;
+      uint64_t rank;
+      if (!v)
+        rank = 2 * max_level + 1;
+      else if (v > 0)
+        rank = 3 * max_level + 2 - level;
+      else
+        rank = level;
+      if (rank > best_rank)
+        best_rank = rank, best = k;
+    }
+    const unsigned tmp = lits[i];
+    lits[i] = lits[best];
+    lits[best] = tmp;
+  }
+
+  const unsigned first = lits[0], second = lits[1];
+  const value first_value = values[first];
+  const value second_value = values[second];
+  const unsigned first_level = all_assigned[IDX (first)].level;
+  const unsigned second_level = all_assigned[IDX (second)].level;
+
+  bool propagate = false;
+  if (second_value < 0) {
+    if (first_value < 0) {
+      // conflicting: unassign the highest falsified level
+      if (first_level == second_level) {
+        assert (first_level);
+        kissat_backtrack (solver, first_level - 1);
+      } else {
+        kissat_backtrack (solver, second_level);
+        propagate = true;
+      }
+    } else if (!first_value || first_level > second_level) {
+      // propagating: 'first' is implied on 'second_level'
+      if (second_level < solver->level)
+        kissat_backtrack (solver, second_level);
+      propagate = true;
+    }
+  }
+
+  assert (EMPTY_STACK (solver->clause.lits));
+  for (int i = 0; i < size; i++)
+    PUSH_STACK (solver->clause.lits, lits[i]);
+  const reference ref = kissat_new_redundant_clause (solver, size);
+  CLEAR_STACK (solver->clause.lits);
+
+  clause *c = 0;
+  if (ref != INVALID_REF) {
+    c = kissat_dereference_clause (solver, ref);
+    c->used = 1 + (glue <= GET_OPTION (tier2));
+    kissat_prs_tag_imported (solver, c, producer);
+  }
+
+  if (propagate) {
+    assert (!VALUE (first));
+    assert (VALUE (second) < 0);
+    if (c)
+      kissat_assign_reference (solver, first, ref, c);
+    else
+      kissat_assign_binary (solver, true, first, second);
+  }
+  return true;
 }
 
 int kissat_importClauses(kissat *solver) {
-  int lbd, glue, k, l, res;
+  int glue, producer;
   assert(solver->importedClause->sz == 0);
+  solver->prs_import_conflicts = solver->statistics.conflicts;
   // while ((res = solver->cbkImportClause(solver->issuer, &lbd, solver->importedClause)) != -1) {
   while (true) {
-    int res = solver->prsImportClause(solver->prsImportState, solver->importedClause, &glue);
+    int res = solver->prsImportClause(solver->prsImportState, solver->importedClause, &glue, &producer);
     if (res == -1) break;
     if (res == -10) {
       cvec_clear(solver->importedClause);
@@ -191,44 +302,104 @@ int kissat_importClauses(kissat *solver) {
       continue;
     }
 
-    bool alreadySat = false;
-    for (k = l = 0; k < solver->importedClause->sz; k++) {
-      int v = cvec_data(solver->importedClause, k);
-      if (solver->values[v] == 1) {
-        alreadySat = true;
-        break;
-      }
-      else if (solver->values[v] == 0)
-        solver->importedClause->data[l++] = v;
-    }
+    const int ok = import_clause (solver, glue, producer);
+    cvec_clear(solver->importedClause);
+    if (!ok)
+      return false;
+  }
+  return true;
+}
 
-    solver->importedClause->sz = l;
-    if (alreadySat) {
-      cvec_clear(solver->importedClause);
+bool kissat_importing (kissat * solver)
+{
+  // level zero imports are done at the top of the search loop
+  if (!solver->prsImportClause || !solver->level)
+    return false;
+  const int interval = GET_OPTION (prsimportint);
+  if (!interval)
+    return false;
+  return solver->statistics.conflicts >= solver->prs_import_conflicts + interval;
+}
+
+// Import the units published in the global unit store since the last
+// call.  Only done at the root level, which the caller has to ensure.
+int
+kissat_importUnitClauses (kissat * solver)
+{
+  if (!solver->prsUnitsEpoch)
+    return true;
+  assert (!solver->level);
+  const unsigned epoch = solver->prsUnitsEpoch (solver->prsUnitState);
+  while (solver->prsUnitsImported < epoch) {
+    const int elit = solver->prsImportUnit (solver->prsUnitState,
+                                            solver->prsUnitsImported);
+    // the slot is reserved but not yet written, try again later
+    if (!elit)
+      break;
+    solver->prsUnitsImported++;
+    assert (VALID_EXTERNAL_LITERAL (elit));
+    const unsigned ilit = kissat_import_literal (solver, elit);
+    if (!VALID_INTERNAL_LITERAL (ilit))
       continue;
-    }
-    if (solver->importedClause->sz == 0) {
-      cvec_clear(solver->importedClause);
+    const flags *flags = FLAGS (IDX (ilit));
+    if (!flags->active || flags->eliminated)
+      continue;
+    const value value = VALUE (ilit);
+    if (value > 0)
+      continue;
+    if (value < 0)
       return false;
+    kissat_assign_unit (solver, ilit);
+  }
+  return true;
+}
+
+// Import the equivalences published in the global equivalence store as
+// pairs of redundant binary clauses and schedule a substitution round,
+// which then removes the substituted variables.  Only done at the root
+// level, and only after enough conflicts since the last substitution.
+int
+kissat_importEquivalences (kissat * solver)
+{
+  if (!kissat_prs_equivalences_pending (solver))
+    return true;
+  assert (!solver->level);
+  const unsigned epoch =
+    solver->prsEquivalencesEpoch (solver->prsEquivalenceState);
+  solver->prs_substitute_conflicts = CONFLICTS;
+  while (solver->prsEquivalencesImported < epoch) {
+    int elit, eother;
+    if (!solver->prsImportEquivalence (solver->prsEquivalenceState,
+                                       solver->prsEquivalencesImported,
+                                       &elit, &eother))
+      break;
+    solver->prsEquivalencesImported++;
+    const unsigned lit = kissat_import_literal (solver, elit);
+    const unsigned other = kissat_import_literal (solver, eother);
+    if (!VALID_INTERNAL_LITERAL (lit) || !VALID_INTERNAL_LITERAL (other))
+      continue;
+    if (IDX (lit) == IDX (other))
+      continue;
+    if (!ACTIVE (IDX (lit)) || !ACTIVE (IDX (other)))
+      continue;
+    const value lit_value = VALUE (lit);
+    const value other_value = VALUE (other);
+    if (lit_value && other_value) {
+      if (lit_value != other_value)
+        return false;
+      continue;
     }
-    if (solver->importedClause->sz == 1) {
-      kissat_assign_unit(solver, solver->importedClause->data[0]);
-      cvec_clear(solver->importedClause);
-    } else {
-      lbd = solver->importedClause->sz;
-      assert (EMPTY_STACK(solver->clause.lits));
-      for (int i = 0; i < solver->importedClause->sz; i++) {
-        PUSH_STACK(solver->clause.lits, solver->importedClause->data[i]);
-      }
-      const reference ref = kissat_new_redundant_clause(solver, lbd);
-      if(ref != INVALID_REF) {
-        assert(solver->importedClause->sz > 2);
-        clause *c = kissat_dereference_clause(solver, ref);
-        c->used = 1 + (glue <= GET_OPTION (tier2));
-      }
-      CLEAR_STACK(solver->clause.lits);
-      cvec_clear(solver->importedClause);
+    if (lit_value) {
+      kissat_assign_unit (solver, lit_value > 0 ? other : NOT (other));
+      continue;
     }
+    if (other_value) {
+      kissat_assign_unit (solver, other_value > 0 ? lit : NOT (lit));
+      continue;
+    }
+    kissat_new_binary_clause (solver, true, NOT (lit), other);
+    kissat_new_binary_clause (solver, true, lit, NOT (other));
+    solver->prsSubstitute = true;
   }
   return true;
-}
\ No newline at end of file
+}
@@ -1,11 +1,15 @@
 #ifndef _learn_h_INCLUDED
 #define _learn_h_INCLUDED
 
+#include <stdbool.h>
+
 struct kissat;
 
 void kissat_learn_clause (struct kissat *);
 
 int  kissat_importClauses(kissat *solver);
+bool kissat_importing (struct kissat *);
 int  kissat_importUnitClauses(kissat *solver);
+int  kissat_importEquivalences(kissat *solver);
 
 #endif
@@ -65,6 +65,8 @@ OPTION( probedelay, 0, 0, 1, "delay probing") \
 OPTION( probeinit, 100, 0, INT_MAX, "initial probing interval") \
 OPTION( probeint, 100, 2, INT_MAX, "probing interval") \
 NQTOPT( profile, 2, 0, 4, "profile level") \
+OPTION( prsimportint, 256, 0, INT_MAX, "conflicts between imports above level zero (0=only level zero)") \
+OPTION( prssubstint, 1000, 0, INT_MAX, "conflicts between substitutions of shared equivalences") \
 NQTOPT( quiet, 0, 0, 1, "disable all messages") \
 OPTION( really, 1, 0, 1, "delay preprocessing after scheduling") \
 OPTION( reduce, 1, 0, 1, "learned clause reduction") \
@@ -1,12 +1,116 @@
+#include "allocate.h"
 #include "internal.h"
 #include "inline.h"
+#include "prs.h"
 
-void kissat_set_prs_export_clause_function(kissat *solver, 
-    prs_export_clause_callback callback, void *state) {
-    assert(callback != NULL);
-    solver->prsExportClause = callback;
-    solver->prsExportState = state;
-    assert(solver->exportedClause != NULL);
+void kissat_enable_prs_export(kissat *solver, unsigned log_size) {
+    assert(!solver->prsExportRing);
+    assert(log_size < 31);
+    const unsigned capacity = 1u << log_size;
+    solver->prsExportRing = kissat_malloc(solver, capacity * sizeof(int));
+    solver->prsExportMask = capacity - 1;
+    solver->prsExportHead = solver->prsExportTail = 0;
+    solver->prsExportGlue = 2;
+    solver->prsExportSize = INT_MAX;
+}
+
+void kissat_enable_prs_inactive(kissat *solver, int vars) {
+    assert(!solver->prsInactive);
+    assert(vars >= 0);
+    solver->prsInactiveVars = vars;
+    solver->prsInactive = kissat_calloc(solver, vars / 64 + 1, sizeof(uint64_t));
+}
+
+const uint64_t *kissat_prs_inactive(kissat *solver) {
+    return solver->prsInactive;
+}
+
+void kissat_enable_prs_usefulness(kissat *solver, int producers) {
+    assert(!solver->prsUsefulness);
+    assert(producers > 0);
+    solver->prsProducers = producers;
+    solver->prsUsefulness = kissat_calloc(solver, 2 * producers, sizeof(uint64_t));
+}
+
+const uint64_t *kissat_prs_usefulness(kissat *solver) {
+    return solver->prsUsefulness;
+}
+
+void kissat_set_prs_export_limit(kissat *solver, int glue, int size) {
+    __atomic_store_n(&solver->prsExportGlue, glue, __ATOMIC_RELAXED);
+    __atomic_store_n(&solver->prsExportSize, size, __ATOMIC_RELAXED);
+}
+
+void kissat_prs_export(kissat *solver, unsigned size, const unsigned *lits, int glue) {
+    assert(solver->prsExportRing);
+    const uint64_t head = solver->prsExportHead;
+    const uint64_t tail = __atomic_load_n(&solver->prsExportTail, __ATOMIC_ACQUIRE);
+    // 整条记录放不下时直接丢弃，分享线程每轮也只会取走share_lits以内的子句
+    if (head - tail + size + 2 > (uint64_t) solver->prsExportMask + 1)
+        return;
+    int *ring = solver->prsExportRing;
+    const unsigned mask = solver->prsExportMask;
+    ring[head & mask] = glue;
+    ring[(head + 1) & mask] = size;
+    for (unsigned i = 0; i < size; i++)
+        ring[(head + 2 + i) & mask] = kissat_export_literal(solver, lits[i]);
+    // 整条记录写完后才发布，保证分享线程不会读到半条子句
+    __atomic_store_n(&solver->prsExportHead, head + size + 2, __ATOMIC_RELEASE);
+}
+
+size_t kissat_prs_export_available(kissat *solver) {
+    if (!solver->prsExportRing)
+        return 0;
+    const uint64_t head = __atomic_load_n(&solver->prsExportHead, __ATOMIC_ACQUIRE);
+    return head - solver->prsExportTail;
+}
+
+void kissat_prs_export_clauses(kissat *solver, int *buffer, size_t n) {
+    const int *ring = solver->prsExportRing;
+    const unsigned mask = solver->prsExportMask;
+    const uint64_t tail = solver->prsExportTail;
+    assert(n <= kissat_prs_export_available(solver));
+    for (size_t i = 0; i < n; i++)
+        buffer[i] = ring[(tail + i) & mask];
+    __atomic_store_n(&solver->prsExportTail, tail + n, __ATOMIC_RELEASE);
+}
+
+void kissat_set_prs_unit_functions(kissat *solver,
+    prs_export_unit_callback export_unit, prs_units_epoch_callback epoch,
+    prs_import_unit_callback import_unit, void *state) {
+    assert(export_unit != NULL && epoch != NULL && import_unit != NULL);
+    solver->prsExportUnit = export_unit;
+    solver->prsUnitsEpoch = epoch;
+    solver->prsImportUnit = import_unit;
+    solver->prsUnitState = state;
+    solver->prsUnitsImported = 0;
+}
+
+bool kissat_prs_units_pending(kissat *solver) {
+    if (!solver->prsUnitsEpoch)
+        return false;
+    return solver->prsUnitsEpoch(solver->prsUnitState) != solver->prsUnitsImported;
+}
+
+void kissat_set_prs_equivalence_functions(kissat *solver,
+    prs_export_equivalence_callback export_equivalence,
+    prs_equivalences_epoch_callback epoch,
+    prs_import_equivalence_callback import_equivalence, void *state) {
+    assert(export_equivalence != NULL && epoch != NULL && import_equivalence != NULL);
+    solver->prsExportEquivalence = export_equivalence;
+    solver->prsEquivalencesEpoch = epoch;
+    solver->prsImportEquivalence = import_equivalence;
+    solver->prsEquivalenceState = state;
+    solver->prsEquivalencesImported = 0;
+}
+
+bool kissat_prs_equivalences_pending(kissat *solver) {
+    if (!solver->prsEquivalencesEpoch)
+        return false;
+    // 每次替换都要遍历整个公式，按冲突数限制频率
+    if (CONFLICTS < solver->prs_substitute_conflicts + GET_OPTION(prssubstint))
+        return false;
+    return solver->prsEquivalencesEpoch(solver->prsEquivalenceState) != solver->prsEquivalencesImported;
 }
 
 void kissat_set_prs_import_clause_function(kissat *solver, 
@@ -0,0 +1,69 @@
+#ifndef _prs_h_INCLUDED
+#define _prs_h_INCLUDED
+
+#include "internal.h"
+
+// 把一条子句写入导出缓冲区，缓冲区满时丢弃
+void kissat_prs_export (kissat * solver, unsigned size, const unsigned *lits,
+                        int glue);
+
+// 全局单元文字表中是否有尚未导入的单元
+bool kissat_prs_units_pending (kissat * solver);
+
+// 全局等价文字表中是否有尚未导入的等价关系，并且距上次替换已足够久
+bool kissat_prs_equivalences_pending (kissat * solver);
+
+// 记录外部变量已固定或被消去
+static inline void
+kissat_prs_mark_inactive (kissat * solver, int elit)
+{
+  const unsigned eidx = elit < 0 ? -elit : elit;
+  if (!solver->prsInactive || eidx > solver->prsInactiveVars)
+    return;
+  __atomic_fetch_or (solver->prsInactive + eidx / 64,
+                     (uint64_t) 1 << (eidx & 63), __ATOMIC_RELAXED);
+}
+
+// 单写者计数器，其他线程只做原子读
+static inline void
+kissat_prs_count (uint64_t * counter)
+{
+  __atomic_store_n (counter, *counter + 1, __ATOMIC_RELAXED);
+}
+
+// 给导入的长子句打上生产者标记(producer + 1)，超出8位的生产者不统计
+static inline void
+kissat_prs_tag_imported (kissat * solver, clause * c, int producer)
+{
+  if (!solver->prsUsefulness || producer < 0)
+    return;
+  if ((unsigned) producer >= solver->prsProducers || producer >= 255)
+    return;
+  c->shared = producer + 1;
+  kissat_prs_count (solver->prsUsefulness + producer);
+}
+
+// 导入的子句第一次参与冲突分析时计为有用，之后清除标记只计一次
+static inline void
+kissat_prs_mark_useful (kissat * solver, clause * c)
+{
+  if (!c->shared)
+    return;
+  const unsigned producer = c->shared - 1;
+  c->shared = 0;
+  kissat_prs_count (solver->prsUsefulness + solver->prsProducers + producer);
+}
+
+// 在复制文字之前按glue和长度过滤，绝大部分学习子句在这里就被丢弃
+static inline bool
+kissat_prs_exporting (kissat * solver, unsigned size, int glue)
+{
+  if (!solver->prsExportRing)
+    return false;
+  if (glue > __atomic_load_n (&solver->prsExportGlue, __ATOMIC_RELAXED))
+    return false;
+  return (int) size <= __atomic_load_n (&solver->prsExportSize,
+                                        __ATOMIC_RELAXED);
+}
+
+#endif
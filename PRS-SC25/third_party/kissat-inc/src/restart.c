@@ -4,6 +4,7 @@
 #include "limits.h"
 #include "logging.h"
 #include "print.h"
+#include "prs.h"
 #include "reluctant.h"
 #include "report.h"
 #include "restart.h"
@@ -143,6 +144,10 @@ kissat_restart (kissat * solver)
   unsigned new_heuristic = solver->heuristic;
 
   unsigned level = old_heuristic==new_heuristic?reuse_trail (solver):0;
+  // 有新的全局单元时回到根层，由搜索循环导入
+  if (kissat_prs_units_pending (solver) ||
+      kissat_prs_equivalences_pending (solver))
+    level = 0;
 
   kissat_extremely_verbose (solver,
 			    "restarting after %" PRIu64 " conflicts"
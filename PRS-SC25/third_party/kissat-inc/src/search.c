@@ -2,6 +2,7 @@
 #include "decide.h"
 #include "eliminate.h"
 #include "internal.h"
+#include "learn.h"
 #include "logging.h"
 #include "print.h"
 #include "probe.h"
@@ -11,6 +12,7 @@
 #include "reluctant.h"
 #include "report.h"
 #include "restart.h"
+#include "substitute.h"
 #include "terminate.h"
 #include "trail.h"
 #include "walk.h"
@@ -170,6 +172,10 @@ int kissat_search(kissat *solver)
       kissat_shuffle_score(solver);
       solver->reseting = 0;
     }
+    if (!solver->level && !kissat_importUnitClauses(solver))
+      return 20;
+    if (!solver->level && !kissat_importEquivalences(solver))
+      return 20;
     if (!solver->level && solver->prsImportClause != NULL) {
       if (!kissat_importClauses(solver)) return 20;
     }
@@ -178,6 +184,11 @@ int kissat_search(kissat *solver)
       res = kissat_analyze(solver, conflict);
     else if (solver->iterating)
       iterate(solver);
+    else if (!solver->level && solver->prsSubstitute)
+      res = kissat_substitute_shared(solver);
+    else if (kissat_importing(solver)) {
+      if (!kissat_importClauses(solver)) res = 20;
+    }
     else if (!solver->unassigned)
       res = 10;
     else if (TERMINATED(11))
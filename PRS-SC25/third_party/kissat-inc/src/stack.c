@@ -3,6 +3,7 @@
 #include "utilities.h"
 
 #include <assert.h>
+#include <string.h>
 
 void
 kissat_stack_enlarge (struct kissat *solver, chars * s, size_t bytes)
@@ -56,3 +57,24 @@ kissat_shrink_stack (struct kissat *solver, chars * s, size_t bytes)
   s->end = s->begin + old_bytes_size;
   assert (s->end <= s->allocated);
 }
+
+void
+kissat_copy_stack (struct kissat *solver, chars * dst, const chars * src,
+		   size_t bytes)
+{
+  assert (bytes > 0);
+  assert (!dst->begin);
+  const size_t size_bytes = SIZE_STACK (*src);
+  assert (!(size_bytes % bytes));
+  const size_t size = size_bytes / bytes;
+  if (!size)
+    return;
+  const size_t capacity = ((size_t) 1) << kissat_ldceil (size);
+  size_t capacity_bytes = capacity * bytes;
+  while (!kissat_aligned_word (capacity_bytes))
+    capacity_bytes <<= 1;
+  dst->begin = kissat_malloc (solver, capacity_bytes);
+  memcpy (dst->begin, src->begin, size_bytes);
+  dst->end = dst->begin + size_bytes;
+  dst->allocated = dst->begin + capacity_bytes;
+}
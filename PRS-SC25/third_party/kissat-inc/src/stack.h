@@ -36,6 +36,12 @@ do { \
   kissat_stack_enlarge (solver, (chars*) &(S), sizeof *(S).begin); \
 } while (0)
 
+#define COPY_STACK(D,S) \
+do { \
+  kissat_copy_stack (solver, (chars*) &(D), (const chars*) &(S), \
+                     sizeof *(S).begin); \
+} while (0)
+
 #define SHRINK_STACK(S) \
 do { \
   if (!FULL_STACK (S)) \
@@ -126,5 +132,7 @@ struct kissat;
 
 void kissat_stack_enlarge (struct kissat *, chars *, size_t size_of_element);
 void kissat_shrink_stack (struct kissat *, chars *, size_t size_of_element);
+void kissat_copy_stack (struct kissat *, chars *, const chars *,
+			size_t size_of_element);
 
 #endif
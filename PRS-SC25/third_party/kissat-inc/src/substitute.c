@@ -260,6 +260,11 @@ add_representative_equivalences (kissat * solver, unsigned *repr)
       ADD_BINARY_TO_PROOF (lit, not_other);
 #endif
       eliminate[idx] = true;
+      // share the equivalence with the other solvers
+      if (solver->prsExportEquivalence)
+        solver->prsExportEquivalence (solver->prsEquivalenceState,
+                                      kissat_export_literal (solver, lit),
+                                      kissat_export_literal (solver, other));
     }
   return eliminate;
 }
@@ -657,3 +662,24 @@ kissat_substitute (kissat * solver, bool first)
     return;
   substitute_rounds (solver);
 }
+
+// Substitute equivalences imported from other solvers right away instead
+// of waiting for the next probing phase.
+int
+kissat_substitute_shared (kissat * solver)
+{
+  assert (!solver->level);
+  assert (!solver->probing);
+  solver->prsSubstitute = false;
+  if (solver->inconsistent)
+    return 20;
+  if (!GET_OPTION (substitute))
+    return 0;
+  kissat_backtrack_propagate_and_flush_trail (solver);
+  STOP_SEARCH_AND_START_SIMPLIFIER (probe);
+  solver->probing = true;
+  substitute_rounds (solver);
+  solver->probing = false;
+  STOP_SIMPLIFIER_AND_RESUME_SEARCH (probe);
+  return solver->inconsistent ? 20 : 0;
+}
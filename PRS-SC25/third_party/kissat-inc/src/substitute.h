@@ -6,5 +6,6 @@
 struct kissat;
 
 void kissat_substitute (struct kissat *, bool first);
+int kissat_substitute_shared (struct kissat *);
 
 #endif
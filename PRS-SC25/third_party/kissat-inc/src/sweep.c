@@ -6,6 +6,7 @@
 #include "print.h"
 #include "promote.h"
 #include "propdense.h"
+#include "prs.h"
 #include "proprobe.h"
 #include "random.h"
 #include "rank.h"
@@ -707,13 +708,12 @@ static bool sweep_backbone_candidate (sweeper *sweeper, unsigned lit) {
 
     // printf("c sweep backbone %d\n", lit);
 
-    if(solver->prsExportState != NULL) {
-      // share sweep backbone
-      int elit = kissat_export_literal(solver, lit);
-      cvec_clear(solver->exportedClause);
-      cvec_push(solver->exportedClause, elit);
-      solver->prsExportClause(solver->prsExportState, solver->exportedClause, 1);
-    }
+    // share sweep backbone
+    if (solver->prsExportUnit)
+      solver->prsExportUnit (solver->prsUnitState,
+                             kissat_export_literal (solver, lit));
+    else if (kissat_prs_exporting (solver, 1, 1))
+      kissat_prs_export (solver, 1, &lit, 1);
 
     save_add_clear_core (sweeper);
     INC (sweep_unsat_backbone);
@@ -1257,23 +1257,15 @@ static bool sweep_equivalence_candidates (sweeper *sweeper, unsigned lit,
 
   // share equivalence
 
-  if(solver->prsExportState != NULL) {
-    int elit = kissat_export_literal(solver, lit);
-    int elit_not = kissat_export_literal(solver, not_lit);
-    
-    int elit_other = kissat_export_literal(solver, other);
-    int elit_not_other = kissat_export_literal(solver, not_other);
-
-    cvec_clear(solver->exportedClause);
-    cvec_push(solver->exportedClause, elit);
-    cvec_push(solver->exportedClause, elit_not_other);
-
-    solver->prsExportClause(solver->prsExportState, solver->exportedClause, 1);
-
-    cvec_clear(solver->exportedClause);
-    cvec_push(solver->exportedClause, elit_not);
-    cvec_push(solver->exportedClause, elit_other);
-    solver->prsExportClause(solver->prsExportState, solver->exportedClause, 1);
+  if (solver->prsExportEquivalence)
+    solver->prsExportEquivalence (solver->prsEquivalenceState,
+                                  kissat_export_literal (solver, lit),
+                                  kissat_export_literal (solver, other));
+  else if (kissat_prs_exporting (solver, 2, 1)) {
+    const unsigned first[2] = { lit, not_other };
+    const unsigned second[2] = { not_lit, other };
+    kissat_prs_export (solver, 2, first, 1);
+    kissat_prs_export (solver, 2, second, 1);
   }
   
   LOG ("sweep equivalence %s = %s", LOGLIT (lit), LOGLIT (other));
@@ -8,59 +8,60 @@
 
 #include <inttypes.h>
 
-unsigned *
-kissat_enlarge_vector (kissat * solver, vectors * vectors, vector * vector)
+static void
+enlarge_vectors (kissat * solver, vectors * vectors, size_t needed)
 {
   unsigneds *stack = &vectors->stack;
-  LOG2 ("enlarging vector %" SECTOR_FORMAT "[%" SECTOR_FORMAT "] at %p",
-	vector->offset, vector->size, vector);
-  const sector old_vector_size = vector->size;
-  assert (old_vector_size < MAX_VECTORS / 2);
-  const sector new_vector_size = old_vector_size ? 2 * old_vector_size : 1;
   size_t old_stack_size = SIZE_STACK (*stack);
   size_t capacity = CAPACITY_STACK (*stack);
   assert (kissat_is_power_of_two (MAX_VECTORS));
   assert (capacity <= MAX_VECTORS);
   size_t available = capacity - old_stack_size;
-  if (new_vector_size > available)
-    {
+  if (needed <= available)
+    return;
 #ifndef QUIET
-      unsigned *old_begin = BEGIN_STACK (*stack);
+  unsigned *old_begin = BEGIN_STACK (*stack);
 #endif
-      unsigned enlarged = 0;
-      do
-	{
-	  assert (kissat_is_zero_or_power_of_two (capacity));
+  do
+    {
+      assert (kissat_is_zero_or_power_of_two (capacity));
 
-	  if (capacity == MAX_VECTORS)
-	    kissat_fatal ("maximum vector stack size "
-			  "of 2^%u entries %s exhausted", LD_MAX_VECTORS,
-			  FORMAT_BYTES (MAX_VECTORS * sizeof (unsigned)));
-	  enlarged++;
-	  kissat_stack_enlarge (solver, (chars *) stack, sizeof (unsigned));
+      if (capacity == MAX_VECTORS)
+	kissat_fatal ("maximum vector stack size "
+		      "of 2^%u entries %s exhausted", LD_MAX_VECTORS,
+		      FORMAT_BYTES (MAX_VECTORS * sizeof (unsigned)));
+      kissat_stack_enlarge (solver, (chars *) stack, sizeof (unsigned));
 
-	  capacity = CAPACITY_STACK (*stack);
-	  available = capacity - old_stack_size;
-	}
-      while (new_vector_size > available);
+      capacity = CAPACITY_STACK (*stack);
+      available = capacity - old_stack_size;
+    }
+  while (needed > available);
 
-      if (enlarged)
-	{
-	  INC (vectors_enlarged);
+  INC (vectors_enlarged);
 #ifndef QUIET
-	  unsigned *new_begin = BEGIN_STACK (*stack);
-	  const uintptr_t moved = new_begin - old_begin;
-	  kissat_phase (solver, "vectors",
-			GET (vectors_enlarged),
-			"enlarged to %s entries %s (%s)",
-			FORMAT_COUNT (capacity),
-			FORMAT_BYTES (capacity * sizeof (unsigned)),
-			(moved ? "moved" : "in place"));
+  unsigned *new_begin = BEGIN_STACK (*stack);
+  const uintptr_t moved = new_begin - old_begin;
+  kissat_phase (solver, "vectors",
+		GET (vectors_enlarged),
+		"enlarged to %s entries %s (%s)",
+		FORMAT_COUNT (capacity),
+		FORMAT_BYTES (capacity * sizeof (unsigned)),
+		(moved ? "moved" : "in place"));
 #endif
-	}
-      assert (capacity <= MAX_VECTORS);
-      assert (new_vector_size <= available);
-    }
+  assert (capacity <= MAX_VECTORS);
+  assert (needed <= available);
+}
+
+unsigned *
+kissat_enlarge_vector (kissat * solver, vectors * vectors, vector * vector)
+{
+  unsigneds *stack = &vectors->stack;
+  LOG2 ("enlarging vector %" SECTOR_FORMAT "[%" SECTOR_FORMAT "] at %p",
+	vector->offset, vector->size, vector);
+  const sector old_vector_size = vector->size;
+  assert (old_vector_size < MAX_VECTORS / 2);
+  const sector new_vector_size = old_vector_size ? 2 * old_vector_size : 1;
+  enlarge_vectors (solver, vectors, new_vector_size);
   unsigned *begin_old_vector = kissat_begin_vector (vectors, vector);
   unsigned *begin_new_vector = END_STACK (*stack);
   unsigned *middle_new_vector = begin_new_vector + old_vector_size;
@@ -84,6 +85,51 @@ kissat_enlarge_vector (kissat * solver, vectors * vectors, vector * vector)
   return middle_new_vector;
 }
 
+void
+kissat_reserve_vectors (kissat * solver, vectors * vectors,
+			unsigned size_vectors, vector * all,
+			const unsigned *extra)
+{
+  unsigneds *stack = &vectors->stack;
+  size_t needed = 0;
+  for (unsigned i = 0; i < size_vectors; i++)
+    if (extra[i])
+      needed += all[i].size + (size_t) extra[i];
+  if (!needed)
+    return;
+  LOG ("reserving %zu vector entries", needed);
+  if (EMPTY_STACK (*stack))
+    PUSH_STACK (*stack, 0);
+  enlarge_vectors (solver, vectors, needed);
+  for (unsigned i = 0; i < size_vectors; i++)
+    {
+      const sector delta_size = extra[i];
+      if (!delta_size)
+	continue;
+      vector *vector = all + i;
+      const sector old_vector_size = vector->size;
+      unsigned *begin_new_vector = END_STACK (*stack);
+      unsigned *middle_new_vector = begin_new_vector + old_vector_size;
+      unsigned *end_new_vector = middle_new_vector + delta_size;
+      assert (end_new_vector <= stack->allocated);
+      if (old_vector_size)
+	{
+	  unsigned *begin_old_vector = kissat_begin_vector (vectors, vector);
+	  const size_t old_bytes = old_vector_size * sizeof (unsigned);
+	  memcpy (begin_new_vector, begin_old_vector, old_bytes);
+	  memset (begin_old_vector, 0xff, old_bytes);
+	  kissat_add_usable (vectors, old_vector_size);
+	}
+      memset (middle_new_vector, 0xff, delta_size * sizeof (unsigned));
+      kissat_add_usable (vectors, delta_size);
+      const uint64_t offset = SIZE_STACK (*stack);
+      assert (offset <= MAX_VECTORS);
+      vector->offset = offset;
+      stack->end = end_new_vector;
+    }
+  kissat_check_vectors (solver);
+}
+
 static inline sector
 rank_offset (vector * unsorted, unsigned i)
 {
@@ -92,6 +92,8 @@ kissat_pop_vector (vectors * vectors, vector * vector)
 }
 
 unsigned *kissat_enlarge_vector (struct kissat *, vectors *, vector *);
+void kissat_reserve_vectors (struct kissat *, vectors *,
+			     unsigned, vector *, const unsigned *);
 void kissat_defrag_vectors (struct kissat *, vectors *, unsigned, vector *);
 void kissat_remove_from_vector (struct kissat *, vectors *, vector *,
 				unsigned);
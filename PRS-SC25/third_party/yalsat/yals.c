@@ -12,6 +12,7 @@
 #include <limits.h>
 #include <math.h>
 #include <stdarg.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -387,6 +388,7 @@ typedef struct Callbacks {
   struct { void * state; int (*fun)(void*); } term;
   struct { void * state; void (*lock)(void*); void (*unlock)(void*); } msg;
   struct { void * state; void (*fun)(void*); } bestphase; // 新增 bestphase 回调
+  struct { void * state; int (*fun)(void*); } units; /* externally fixed literals */
 } Callbacks;
 
 typedef unsigned char U1;
@@ -415,6 +417,7 @@ struct Yals {
   int * pos, * lits; Lnk ** lnk;
   int * crit; unsigned * weightedbreak;
   int nclauses, nbin, ntrn, minlen, maxlen; double avglen;
+  int connected; atomic_int * shared;
   STACK(unsigned) breaks; STACK(double) scores; STACK(int) cands;
   STACK(Word*) cache; int cachesizetarget; STACK(Word) sigs;
   STACK(int) minlits;
@@ -1843,6 +1846,25 @@ static void yals_set_units (Yals * yals) {
   assert (c == yals->clear + yals->nvarwords);
 }
 
+static void yals_import_units (Yals * yals) {
+  int lit, idx, count = 0;
+  if (!yals->cbs.units.fun) return;
+  while ((lit = yals->cbs.units.fun (yals->cbs.units.state))) {
+    idx = ABS (lit);
+    if (idx >= yals->nvars) continue;
+    LOG ("importing unit %d", lit);
+    if (lit > 0) {
+      SETBIT (yals->set, yals->nvarwords, idx);
+      SETBIT (yals->clear, yals->nvarwords, idx);
+    } else {
+      CLRBIT (yals->set, yals->nvarwords, idx);
+      CLRBIT (yals->clear, yals->nvarwords, idx);
+    }
+    count++;
+  }
+  if (count) yals_msg (yals, 2, "imported %d units", count);
+}
+
 static void yals_setphases (Yals * yals) {
   int i, idx, lit;
   yals_msg (yals, 1,
@@ -2034,13 +2056,21 @@ static void yals_init_weight_to_score_table (Yals * yals) {
 
 /*------------------------------------------------------------------------*/
 
-static void yals_connect (Yals * yals) {
+/* Connecting is split into two parts.  The first part only depends on the
+ * clauses and builds the read-only clause and occurrence arrays, which can
+ * then be shared with clones (see 'yals_clone').  The second part allocates
+ * and initializes the state which each instance modifies during search.
+ */
+
+static void yals_connect_formula (Yals * yals) {
   int idx, n, lit, nvars = yals->nvars, * count, cidx, sign;
   long long sumoccs, sumlen; int minoccs, maxoccs, minlen, maxlen;
-  int * occsptr, occs, len, lits, maxidx, nused, uniform;
+  int * occsptr, occs, len, lits, maxidx, nused;
   int nclauses, nbin, ntrn, nquad, nlarge;
   const int * p,  * q;
 
+  assert (!yals->connected);
+
   FIT (yals->cdb);
   RELEASE (yals->mark);
   RELEASE (yals->clause);
@@ -2078,11 +2108,6 @@ static void yals_connect (Yals * yals) {
 
   yals->maxlen = maxlen;
   yals->minlen = minlen;
-#ifndef NYALSTATS
-  yals->stats.nincdec = MAX (maxlen + 1, 3);
-  NEWN (yals->stats.inc, yals->stats.nincdec);
-  NEWN (yals->stats.dec, yals->stats.nincdec);
-#endif
 
   if ((INT_MAX >> LENSHIFT) < nclauses)
     yals_abort (yals,
@@ -2103,8 +2128,6 @@ static void yals_connect (Yals * yals) {
   }
   assert (lits == COUNT (yals->cdb));
 
-  NEWN (yals->weights, MAXLEN + 1);
-
   NEWN (count, 2*nvars);
   count += nvars;
 
@@ -2175,18 +2198,6 @@ static void yals_connect (Yals * yals) {
       nlarge, yals_pct (nlarge, yals->nclauses));
   }
 
-  if (minlen == maxlen) uniform = !yals->opts.toggleuniform.val;
-  else uniform = yals->opts.toggleuniform.val;
-
-  if (uniform) {
-    yals_msg (yals, 1,
-      "using uniform strategy for clauses of length %d", maxlen);
-    yals->uniform = maxlen;
-  } else {
-    yals_msg (yals, 1, "using standard non-uniform strategy");
-    yals->uniform = 0;
-  }
-
   yals_msg (yals, 1,
     "clause variable ratio %.3f = %d / %d",
     yals_avg (nclauses, nused), nclauses, nused);
@@ -2235,6 +2246,36 @@ static void yals_connect (Yals * yals) {
     "average literal occurrence %.2f (min %d, max %d)",
     yals_avg (sumoccs, yals->nvars)/2.0, minoccs, maxoccs);
 
+  yals->connected = 1;
+}
+
+static void yals_connect_state (Yals * yals) {
+  int nvars = yals->nvars, nclauses = yals->nclauses, cidx, lit, idx;
+  int minlen = yals->minlen, maxlen = yals->maxlen, uniform;
+  const int * p;
+
+  assert (yals->connected);
+
+#ifndef NYALSTATS
+  yals->stats.nincdec = MAX (maxlen + 1, 3);
+  NEWN (yals->stats.inc, yals->stats.nincdec);
+  NEWN (yals->stats.dec, yals->stats.nincdec);
+#endif
+
+  NEWN (yals->weights, MAXLEN + 1);
+
+  if (minlen == maxlen) uniform = !yals->opts.toggleuniform.val;
+  else uniform = yals->opts.toggleuniform.val;
+
+  if (uniform) {
+    yals_msg (yals, 1,
+      "using uniform strategy for clauses of length %d", maxlen);
+    yals->uniform = maxlen;
+  } else {
+    yals_msg (yals, 1, "using standard non-uniform strategy");
+    yals->uniform = 0;
+  }
+
   if (yals->uniform) yals->pick = yals->opts.unipick.val;
   else yals->pick = yals->opts.pick.val;
 
@@ -2260,16 +2301,19 @@ static void yals_connect (Yals * yals) {
     yals->nvarwords * sizeof (Word),
     (yals->nvarwords * sizeof (Word) >> 10));
 
+  /* The root level units on the trail are kept (and not popped) since
+   * clones made later on need them too.
+   */
+
   NEWN (yals->set, yals->nvarwords);
   NEWN (yals->clear, yals->nvarwords);
   memset (yals->clear, 0xff, yals->nvarwords * sizeof (Word));
-  while (!EMPTY (yals->trail)) {
-    lit = POP (yals->trail);
+  for (p = yals->trail.start; p < yals->trail.top; p++) {
+    lit = *p;
     idx = ABS (lit);
     if (lit < 0) CLRBIT (yals->clear, yals->nvarwords, idx);
     else SETBIT (yals->set, yals->nvarwords, idx);
   }
-  RELEASE (yals->trail);
 
   NEWN (yals->vals, yals->nvarwords);
   NEWN (yals->best, yals->nvarwords);
@@ -2521,10 +2565,58 @@ static void yals_reset_cache (Yals * yals) {
   yals_msg (yals, 1, "reset %d cache lines", ncache);
 }
 
+static size_t yals_formula_bytes (Yals * yals) {
+  size_t res = SIZE (yals->cdb);
+  res += yals->nclauses;
+  res += yals->noccs;
+  res += 2*(size_t) yals->nvars;
+  return res * sizeof (int);
+}
+
+/* The first clone turns the connected clauses and occurrence lists into a
+ * reference counted formula, which is then no longer accounted for in the
+ * allocation statistics of any instance and is deallocated by the last
+ * instance referencing it.
+ */
+
+static void yals_share_formula (Yals * yals) {
+  assert (yals->connected);
+  if (yals->shared) return;
+  yals->shared = yals->mem.malloc (yals->mem.mgr, sizeof *yals->shared);
+  if (!yals->shared)
+    yals_abort (yals, "out-of-memory allocating shared formula counter");
+  atomic_init (yals->shared, 1);
+  yals_dec_allocated (yals, yals_formula_bytes (yals));
+}
+
+static void yals_release_formula (Yals * yals) {
+  if (yals->shared) {
+    if (atomic_fetch_sub (yals->shared, 1) == 1) {
+      yals->mem.free (yals->mem.mgr, yals->cdb.start,
+        SIZE (yals->cdb) * sizeof *yals->cdb.start);
+      yals->mem.free (yals->mem.mgr, yals->lits,
+        yals->nclauses * sizeof *yals->lits);
+      yals->mem.free (yals->mem.mgr, yals->occs,
+        yals->noccs * sizeof *yals->occs);
+      yals->mem.free (yals->mem.mgr, yals->refs,
+        2*yals->nvars * sizeof *yals->refs);
+      yals->mem.free (yals->mem.mgr, yals->shared, sizeof *yals->shared);
+      yals_msg (yals, 2, "released shared formula");
+    }
+    INIT (yals->cdb);
+    yals->lits = yals->occs = yals->refs = 0;
+    yals->shared = 0;
+  } else {
+    RELEASE (yals->cdb);
+    DELN (yals->lits, yals->nclauses);
+    DELN (yals->occs, yals->noccs);
+    if (yals->refs) DELN (yals->refs, 2*yals->nvars);
+  }
+}
+
 void yals_del (Yals * yals) {
   yals_reset_cache (yals);
   yals_reset_unsat (yals);
-  RELEASE (yals->cdb);
   RELEASE (yals->clause);
   RELEASE (yals->mark);
   RELEASE (yals->mins);
@@ -2539,7 +2631,7 @@ void yals_del (Yals * yals) {
   RELEASE (yals->minlits);
   if (yals->unsat.usequeue) DELN (yals->lnk, yals->nclauses);
   else DELN (yals->pos, yals->nclauses);
-  DELN (yals->lits, yals->nclauses);
+  yals_release_formula (yals);
   if (yals->crit) DELN (yals->crit, yals->nclauses);
   if (yals->weightedbreak) DELN (yals->weightedbreak, 2*yals->nvars);
   if (yals->satcntbytes == 1) DELN (yals->satcnt1, yals->nclauses);
@@ -2551,8 +2643,6 @@ void yals_del (Yals * yals) {
   DELN (yals->tmp, yals->nvarwords);
   DELN (yals->clear, yals->nvarwords);
   DELN (yals->set, yals->nvarwords);
-  DELN (yals->occs, yals->noccs);
-  if (yals->refs) DELN (yals->refs, 2*yals->nvars);
   if (yals->flips) DELN (yals->flips, yals->nvars);
 #ifndef NYALSTATS
   DELN (yals->stats.inc, yals->stats.nincdec);
@@ -2608,6 +2698,11 @@ void yals_seterm (Yals * yals, int (*term)(void *), void * state) {
   yals->cbs.term.fun = term;
 }
 
+void yals_setunits (Yals * yals, int (*next)(void *), void * state) {
+  yals->cbs.units.state = state;
+  yals->cbs.units.fun = next;
+}
+
 void yals_setmsglock (Yals * yals,
                       void (*lock)(void *),
                       void (*unlock)(void *),
@@ -2866,6 +2961,7 @@ static void yals_restart_inner (Yals * yals) {
     yals_cache_assignment (yals);
     yals_pick_strategy (yals);
     yals_fix_strategy (yals);
+    yals_import_units (yals);
     yals_pick_assignment (yals, 0);
     yals_update_sat_and_unsat (yals);
     yals->stats.tmp = INT_MAX;
@@ -3018,11 +3114,11 @@ DONE:
   return res;
 }
 
-int yals_sat (Yals * yals) {
-  int res, limited = 0, lkhd;
-
+int yals_prepare (Yals * yals) {
   if (!EMPTY (yals->clause))
-    yals_abort (yals, "added clause incomplete in 'yals_sat'");
+    yals_abort (yals, "added clause incomplete in 'yals_prepare'");
+
+  if (yals->connected) return 0;
 
   if (yals->mt) {
     yals_msg (yals, 1, "original formula contains empty clause");
@@ -3038,10 +3134,72 @@ int yals_sat (Yals * yals) {
     }
   }
 
+  yals_connect_formula (yals);
+
+  return 0;
+}
+
+Yals * yals_clone (Yals * yals) {
+  const int * p;
+  Yals * res;
+
+  if (!yals->connected && !yals->mt)
+    yals_abort (yals, "can only clone prepared instance in 'yals_clone'");
+
+  res = yals_new_with_mem_mgr (yals->mem.mgr,
+          yals->mem.malloc, yals->mem.realloc, yals->mem.free);
+  res->out = yals->out;
+  res->colored = yals->colored;
+  yals_strdel (res, res->opts.prefix);
+  res->opts = yals->opts;
+  res->opts.prefix = yals_strdup (res, yals->opts.prefix);
+
+  if (yals->mt) {
+    res->mt = 1;
+    return res;
+  }
+
+  yals_share_formula (yals);
+
+  res->nvars = yals->nvars;
+  res->nclauses = yals->nclauses;
+  res->nbin = yals->nbin;
+  res->ntrn = yals->ntrn;
+  res->minlen = yals->minlen;
+  res->maxlen = yals->maxlen;
+  res->avglen = yals->avglen;
+
+  res->cdb = yals->cdb;
+  res->lits = yals->lits;
+  res->occs = yals->occs;
+  res->noccs = yals->noccs;
+  res->refs = yals->refs;
+  res->shared = yals->shared;
+  atomic_fetch_add (res->shared, 1);
+  res->connected = 1;
+
+  for (p = yals->trail.start; p < yals->trail.top; p++)
+    PUSH (res->trail, *p);
+
+  yals_msg (res, 1,
+    "cloned %d clauses over %d variables",
+    res->nclauses, res->nvars - 1);
+
+  return res;
+}
+
+int yals_sat (Yals * yals) {
+  int res, limited = 0, lkhd;
+
+  if (!EMPTY (yals->clause))
+    yals_abort (yals, "added clause incomplete in 'yals_sat'");
+
+  if (yals_prepare (yals)) return 20;
+
   yals->stats.time.entered = yals_time (yals);
 
   if (yals->opts.setfpu.val) yals_set_fpu (yals);
-  yals_connect (yals);
+  yals_connect_state (yals);
 
   res = 0;
   limited += (yals->limits.flips >= 0);
@@ -45,6 +45,21 @@ int yals_sat (Yals *);
 
 /*------------------------------------------------------------------------*/
 
+/* Only propagate units and connect the clauses without searching.
+ * Returns 20 if the formula is unsatisfiable and 0 otherwise.
+ */
+int yals_prepare (Yals *);
+
+/* Clone a prepared instance.  The read-only clauses and occurrence lists
+ * are shared with the source and the clone only allocates its own search
+ * state.  Options are copied, while the seed, limits and call-backs have to
+ * be set again.  A clone of an unsatisfiable instance is unsatisfiable too.
+ * All clones have to be made before the source starts searching.
+ */
+Yals * yals_clone (Yals *);
+
+/*------------------------------------------------------------------------*/
+
 long long yals_flips (Yals *);
 long long yals_mems (Yals *);
 
@@ -62,6 +77,11 @@ void yals_stats (Yals *);
 
 void yals_seterm (Yals *, int (*term)(void*), void*);
 
+/* Called at every inner restart to fetch newly fixed literals one at a
+ * time, until it returns 0.
+ */
+void yals_setunits (Yals *, int (*next)(void*), void*);
+
 void yals_setime (Yals *, double (*time)(void));
 
 void yals_setmsglock (Yals *,